@@ -0,0 +1,77 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Kept out of line: replacements must not be inline, and callers must not see
+// that they pair with malloc and free.
+
+void* operator new(std::size_t size) {
+    ttd::globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    ttd::threadAllocatedBytes += size;
+    if (void* const p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    ttd::globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    ttd::threadAllocatedBytes += size;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ttd::globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    ttd::threadAllocatedBytes += size;
+    std::size_t const align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a multiple of the alignment.
+    if (void* const p = std::aligned_alloc(align, (size + align - 1) / align * align + (size == 0 ? align : 0))) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Counts the program's calls to the global operator new, to check that a hot
+// path does not touch the heap, and the bytes each thread asked for.
+//
+// Linking allocation_counter.cpp into a program replaces its global operator
+// new and delete with counting ones; without it the count stays 0.
+
+namespace ttd {
+    inline std::atomic<std::size_t> globalAllocationCount{ 0 };
+    inline thread_local std::size_t threadAllocatedBytes = 0;
+
+    inline std::size_t allocationCount() {
+        return globalAllocationCount.load(std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,131 @@
+#include "batch_deduction.hpp"
+
+#include "batch_lanes.hpp"
+
+#if defined(TTD_BATCH_SIMD) && defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace ttd {
+    namespace {
+        // One lane, for the tail of a batch and for CPUs without SIMD.
+        struct ScalarLanes {
+            using Vec = PackedType;
+            static constexpr std::size_t width = 1;
+
+            static Vec load(const PackedType* p) { return *p; }
+            static void store(PackedType* p, Vec v) { *p = v; }
+            static Vec loadCategories(const ValueCategory* p) { return static_cast<PackedType>(*p); }
+
+            static Vec set(PackedType bits) { return bits; }
+            static Vec and_(Vec a, Vec b) { return a & b; }
+            static Vec or_(Vec a, Vec b) { return a | b; }
+            static Vec clear(Vec a, Vec b) { return a & ~b; }
+            static Vec eq(Vec a, Vec b) { return a == b ? ~PackedType(0) : 0; }
+            static Vec invert(Vec mask) { return ~mask; }
+            static Vec select(Vec mask, Vec a, Vec b) { return (a & mask) | (b & ~mask); }
+            static Vec add(Vec a, Vec b) { return a + b; }
+            static Vec sub(Vec a, Vec b) { return a - b; }
+            template <int N> static Vec shl(Vec a) { return a << N; }
+            template <int N> static Vec shr(Vec a) { return a >> N; }
+        };
+
+#if defined(TTD_BATCH_SIMD) && defined(_MSC_VER) && !defined(__clang__)
+        bool cpuSupports(BatchKernel kernel) {
+            int info[4];
+            __cpuid(info, 1);
+            if (kernel == BatchKernel::sse41) {
+                return (info[2] & (1 << 19)) != 0;
+            }
+            // AVX2 also needs the OS to save the ymm registers.
+            bool const osxsave = (info[2] & (1 << 27)) != 0;
+            if (!osxsave || (_xgetbv(0) & 6) != 6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+        }
+#elif defined(TTD_BATCH_SIMD)
+        bool cpuSupports(BatchKernel kernel) {
+            return kernel == BatchKernel::sse41 ? __builtin_cpu_supports("sse4.1") : __builtin_cpu_supports("avx2");
+        }
+#else
+        bool cpuSupports(BatchKernel) {
+            return false;
+        }
+#endif
+
+        // Chunk size of the model-type path, so it needs no heap.
+        constexpr std::size_t chunkSize = 256;
+    }
+
+    bool batchKernelSupported(BatchKernel kernel) {
+        if (kernel == BatchKernel::scalar) {
+            return true;
+        }
+        static bool const sse41 = cpuSupports(BatchKernel::sse41);
+        static bool const avx2 = cpuSupports(BatchKernel::avx2);
+        return kernel == BatchKernel::sse41 ? sse41 : avx2;
+    }
+
+    BatchKernel bestBatchKernel() {
+        static BatchKernel const best = batchKernelSupported(BatchKernel::avx2) ? BatchKernel::avx2
+            : batchKernelSupported(BatchKernel::sse41) ? BatchKernel::sse41
+            : BatchKernel::scalar;
+        return best;
+    }
+
+    PackedDeduction deducePacked(PackedType arg, ValueCategory category, DeductionForm form) {
+        PackedDeduction result;
+        detail::deduceLanes<ScalarLanes>(form, &arg, &category, 1, &result.param, &result.T);
+        return result;
+    }
+
+    void deduceBatch(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                     std::size_t count, PackedType* params, PackedType* Ts) {
+        deduceBatch(bestBatchKernel(), form, args, categories, count, params, Ts);
+    }
+
+    void deduceBatch(BatchKernel kernel, DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                     std::size_t count, PackedType* params, PackedType* Ts) {
+        std::size_t done = 0;
+        if (kernel == BatchKernel::avx2 && batchKernelSupported(kernel)) {
+            done = detail::deduceLanesAvx2(form, args, categories, count, params, Ts);
+        } else if (kernel == BatchKernel::sse41 && batchKernelSupported(kernel)) {
+            done = detail::deduceLanesSse41(form, args, categories, count, params, Ts);
+        }
+        detail::deduceLanes<ScalarLanes>(form, args + done, categories + done, count - done, params + done, Ts + done);
+    }
+
+    void deduceBatch(DeductionEngine& engine, PackedTypeCodec& codec, DeductionForm form,
+                     const Type* const* args, const ValueCategory* categories,
+                     std::size_t count, DeductionResult* results) {
+        PackedType packedArgs[chunkSize];
+        ValueCategory packedCategories[chunkSize];
+        std::size_t indices[chunkSize];
+        PackedType params[chunkSize];
+        PackedType Ts[chunkSize];
+
+        for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+            std::size_t const end = count - begin < chunkSize ? count : begin + chunkSize;
+
+            std::size_t packedCount = 0;
+            for (std::size_t i = begin; i < end; ++i) {
+                PackedType const packed = codec.pack(args[i]);
+                if (packed == packed::none) {
+                    results[i] = engine.deduce(args[i], categories[i], form);
+                    continue;
+                }
+                packedArgs[packedCount] = packed;
+                packedCategories[packedCount] = categories[i];
+                indices[packedCount] = i;
+                ++packedCount;
+            }
+
+            deduceBatch(form, packedArgs, packedCategories, packedCount, params, Ts);
+            for (std::size_t j = 0; j < packedCount; ++j) {
+                results[indices[j]] = { codec.unpack(params[j]), codec.unpack(Ts[j]) };
+            }
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include "deduction_engine.hpp"
+#include "packed_type_codec.hpp"
+#include "value_category.hpp"
+
+// Deduction for the seven passBy* forms over packed types, many at a time.
+//
+// On the packed encoding every rule of DeductionEngine is a bit operation:
+// stripping a reference clears two bits, dropping top-level cv clears the cv
+// field the top level lives in, array-to-pointer decay clears the array bit,
+// function-to-pointer decay adds a pointer layer, and T&& collapsing sets the
+// reference field. The kernel is written once over a lane type and compiled
+// for one lane (the scalar fallback), SSE4.1 (2 lanes) and AVX2 (4 lanes);
+// the widest one the CPU supports is picked at runtime.
+//
+// Inputs and outputs are structure-of-arrays. All items of a batch use the
+// same form, so a kernel never branches per item.
+
+namespace ttd {
+    enum class BatchKernel : unsigned char {
+        scalar,
+        sse41,
+        avx2,
+    };
+
+    struct PackedDeduction {
+        PackedType param;       // packed::none when the call does not compile
+        PackedType T;
+    };
+
+    // Whether kernel was built into this binary and the CPU can run it.
+    bool batchKernelSupported(BatchKernel kernel);
+
+    // The widest supported kernel.
+    BatchKernel bestBatchKernel();
+
+    // One item, on the scalar kernel.
+    PackedDeduction deducePacked(PackedType arg, ValueCategory category, DeductionForm form);
+
+    // params[i] and Ts[i] receive the deduction for args[i] and categories[i].
+    void deduceBatch(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                     std::size_t count, PackedType* params, PackedType* Ts);
+
+    void deduceBatch(BatchKernel kernel, DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                     std::size_t count, PackedType* params, PackedType* Ts);
+
+    // Model types in and out: the ones that pack go through the kernel, the
+    // others through engine. Each pair still costs a codec lookup for the
+    // argument and two for the results, which is more than one engine memo
+    // hit: this is for callers that hold model types anyway. For throughput,
+    // pack the arguments once and use the packed overloads above.
+    void deduceBatch(DeductionEngine& engine, PackedTypeCodec& codec, DeductionForm form,
+                     const Type* const* args, const ValueCategory* categories,
+                     std::size_t count, DeductionResult* results);
+}
@@ -0,0 +1,49 @@
+// Built with AVX2 enabled (see CMakeLists.txt); only the lane type and the
+// kernel live here.
+
+#include "batch_lanes.hpp"
+
+#ifdef TTD_BATCH_SIMD
+#include <immintrin.h>
+
+namespace ttd {
+    namespace {
+        struct Avx2Lanes {
+            using Vec = __m256i;
+            static constexpr std::size_t width = 4;
+
+            static Vec load(const PackedType* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+            static void store(PackedType* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+            static Vec loadCategories(const ValueCategory* p) {
+                return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            }
+
+            static Vec set(PackedType bits) { return _mm256_set1_epi64x(static_cast<long long>(bits)); }
+            static Vec and_(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+            static Vec or_(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+            static Vec clear(Vec a, Vec b) { return _mm256_andnot_si256(b, a); }
+            static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi64(a, b); }
+            static Vec invert(Vec mask) { return _mm256_xor_si256(mask, _mm256_set1_epi64x(-1)); }
+            static Vec select(Vec mask, Vec a, Vec b) { return _mm256_blendv_epi8(b, a, mask); }
+            static Vec add(Vec a, Vec b) { return _mm256_add_epi64(a, b); }
+            static Vec sub(Vec a, Vec b) { return _mm256_sub_epi64(a, b); }
+            template <int N> static Vec shl(Vec a) { return _mm256_slli_epi64(a, N); }
+            template <int N> static Vec shr(Vec a) { return _mm256_srli_epi64(a, N); }
+        };
+    }
+}
+#endif
+
+namespace ttd {
+    namespace detail {
+        std::size_t deduceLanesAvx2(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                                     std::size_t count, PackedType* params, PackedType* Ts) {
+#ifdef TTD_BATCH_SIMD
+            return deduceLanes<Avx2Lanes>(form, args, categories, count, params, Ts);
+#else
+            (void)form, (void)args, (void)categories, (void)count, (void)params, (void)Ts;
+            return 0;
+#endif
+        }
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+
+#include "deduction_form.hpp"
+#include "packed_type.hpp"
+#include "value_category.hpp"
+
+// The batch deduction kernel, written once over a lane type.
+//
+// A lane type L provides a vector of L::width packed words and the handful of
+// operations the rules need: load/store, set, and/or, clear (a & ~b), eq (a
+// lane mask), invert, select (mask ? a : b), add, sub and constant shifts.
+// Masks are all ones or all zeros per lane. The kernel TUs instantiate it for
+// their own instruction set, and this header stays free of anything else so
+// no code built for a wider instruction set leaks into other TUs.
+
+namespace ttd {
+    namespace detail {
+        static_assert(sizeof(ValueCategory) == 4, "the lane types widen categories from 32 bits");
+
+        // Where the parts the rules look at live in x, one mask per lane.
+        template <typename L>
+        struct PackedShape {
+            using Vec = typename L::Vec;
+
+            Vec function;   // x is a function type
+            Vec array0;     // x is an array
+            Vec cv;         // the cv field of x's top level
+
+            explicit PackedShape(Vec x) {
+                Vec const zero = L::set(0);
+                Vec const count = L::and_(x, L::set(packed::countMask));
+                Vec const empty = L::eq(count, zero);
+                Vec const single = L::eq(count, L::set(packed::countOne));
+                function = L::and_(empty, L::eq(L::and_(x, L::set(packed::functionBase)), L::set(packed::functionBase)));
+                array0 = L::clear(L::eq(L::and_(x, L::set(packed::layer0Array)), L::set(packed::layer0Array)), empty);
+                cv = L::select(L::or_(empty, L::and_(array0, single)), L::set(packed::baseCv),
+                               L::select(array0, L::set(packed::layer1Cv), L::set(packed::layer0Cv)));
+            }
+        };
+
+        // Removes layer 0, which must be a pointer.
+        template <typename L>
+        typename L::Vec popLayer(typename L::Vec x) {
+            auto const layers = L::and_(L::template shr<packed::layerBits>(L::and_(x, L::set(packed::layersMask))), L::set(packed::layersMask));
+            auto const count = L::sub(L::and_(x, L::set(packed::countMask)), L::set(packed::countOne));
+            return L::or_(L::or_(L::clear(x, L::set(packed::layersMask | packed::countMask)), layers), count);
+        }
+
+        // Adds a pointer without cv as layer 0; x must have a free layer.
+        template <typename L>
+        typename L::Vec pushPointer(typename L::Vec x) {
+            auto const layers = L::and_(L::template shl<packed::layerBits>(L::and_(x, L::set(packed::layersMask))), L::set(packed::layersMask));
+            auto const count = L::add(L::and_(x, L::set(packed::countMask)), L::set(packed::countOne));
+            return L::or_(L::or_(L::clear(x, L::set(packed::layersMask | packed::countMask)), layers), count);
+        }
+
+        template <typename L, DeductionForm Form>
+        void deduceLane(typename L::Vec arg, typename L::Vec category, typename L::Vec& param, typename L::Vec& T) {
+            using Vec = typename L::Vec;
+
+            Vec const x = L::clear(arg, L::set(packed::referenceMask));
+            PackedShape<L> const shape(x);
+            Vec const lvalue = L::or_(shape.function, L::eq(category, L::set(static_cast<PackedType>(ValueCategory::lvalue))));
+            Vec const constBits = L::and_(shape.cv, L::set(packed::anyConst));
+            Vec const lref = L::or_(x, L::set(packed::lvalueReference));
+            Vec const rref = L::or_(x, L::set(packed::rvalueReference));
+            Vec viable = L::eq(x, x);
+
+            // Array-to-pointer and function-to-pointer conversion; either way
+            // the top level becomes a pointer without cv.
+            Vec decayed = L::select(shape.array0, L::clear(x, L::set(packed::layer0Array | packed::boundMask)), x);
+            decayed = L::or_(decayed, L::and_(shape.function, L::set(packed::countOne)));
+            Vec const decayedCv = L::select(L::or_(shape.array0, shape.function), L::set(packed::layer0Cv), shape.cv);
+
+            if constexpr (Form == DeductionForm::passByValue) {
+                T = L::clear(decayed, decayedCv);
+                param = T;
+            } else if constexpr (Form == DeductionForm::passByRef) {
+                viable = L::or_(lvalue, L::eq(L::and_(x, shape.cv), constBits));
+                param = lref;
+                T = x;
+            } else if constexpr (Form == DeductionForm::passByURef) {
+                param = L::select(lvalue, lref, rref);
+                T = L::select(lvalue, lref, x);
+            } else if constexpr (Form == DeductionForm::passByPtr) {
+                viable = L::invert(L::eq(L::and_(decayed, L::set(packed::countMask)), L::set(0)));
+                param = L::clear(decayed, L::set(packed::layer0Cv));
+                T = popLayer<L>(decayed);
+            } else if constexpr (Form == DeductionForm::passByCPtr) {
+                Vec const pointee = popLayer<L>(decayed);
+                PackedShape<L> const pointeeShape(pointee);
+                Vec const pointeeConst = L::and_(pointeeShape.cv, L::set(packed::anyConst));
+                viable = L::clear(L::invert(L::eq(L::and_(decayed, L::set(packed::countMask)), L::set(0))), pointeeShape.function);
+                T = L::clear(pointee, pointeeConst);
+                param = pushPointer<L>(L::or_(T, pointeeConst));
+            } else if constexpr (Form == DeductionForm::passByCRef) {
+                Vec const isVolatile = L::invert(L::eq(L::and_(x, L::and_(shape.cv, L::set(packed::anyVolatile))), L::set(0)));
+                viable = L::or_(lvalue, L::invert(isVolatile));
+                param = L::select(shape.function, lref, L::or_(lref, constBits));
+                T = L::select(shape.function, x, L::clear(x, constBits));
+            } else {
+                viable = L::or_(shape.function, L::invert(lvalue));
+                param = L::select(shape.function, rref, L::or_(rref, constBits));
+                T = L::select(shape.function, x, L::clear(x, constBits));
+            }
+
+            param = L::select(viable, param, L::set(packed::none));
+            T = L::select(viable, T, L::set(packed::none));
+        }
+
+        template <typename L, DeductionForm Form>
+        std::size_t deduceLanesFor(const PackedType* args, const ValueCategory* categories,
+                                   std::size_t count, PackedType* params, PackedType* Ts) {
+            std::size_t i = 0;
+            for (; i + L::width <= count; i += L::width) {
+                typename L::Vec param;
+                typename L::Vec T;
+                deduceLane<L, Form>(L::load(args + i), L::loadCategories(categories + i), param, T);
+                L::store(params + i, param);
+                L::store(Ts + i, T);
+            }
+            return i;
+        }
+
+        // Returns how many leading items were done, a multiple of L::width.
+        template <typename L>
+        std::size_t deduceLanes(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                                std::size_t count, PackedType* params, PackedType* Ts) {
+            switch (form) {
+            case DeductionForm::passByValue:
+                return deduceLanesFor<L, DeductionForm::passByValue>(args, categories, count, params, Ts);
+            case DeductionForm::passByRef:
+                return deduceLanesFor<L, DeductionForm::passByRef>(args, categories, count, params, Ts);
+            case DeductionForm::passByURef:
+                return deduceLanesFor<L, DeductionForm::passByURef>(args, categories, count, params, Ts);
+            case DeductionForm::passByPtr:
+                return deduceLanesFor<L, DeductionForm::passByPtr>(args, categories, count, params, Ts);
+            case DeductionForm::passByCPtr:
+                return deduceLanesFor<L, DeductionForm::passByCPtr>(args, categories, count, params, Ts);
+            case DeductionForm::passByCRef:
+                return deduceLanesFor<L, DeductionForm::passByCRef>(args, categories, count, params, Ts);
+            case DeductionForm::passByCRRef:
+                return deduceLanesFor<L, DeductionForm::passByCRRef>(args, categories, count, params, Ts);
+            }
+            return 0;
+        }
+
+        // Entry points of the SIMD kernel TUs. They do nothing when the kernel
+        // was not built in.
+        std::size_t deduceLanesSse41(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                                     std::size_t count, PackedType* params, PackedType* Ts);
+        std::size_t deduceLanesAvx2(DeductionForm form, const PackedType* args, const ValueCategory* categories,
+                                    std::size_t count, PackedType* params, PackedType* Ts);
+    }
+}
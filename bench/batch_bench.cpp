@@ -0,0 +1,85 @@
+// Throughput of batch deduction: the packed kernels against the memoized
+// DeductionEngine, on every argument shape of the report times every form.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "../batch_deduction.hpp"
+#include "../type_parser.hpp"
+
+namespace {
+    const char* const spellings[] = {
+        "int", "int*", "int const", "int const*", "int const* const",
+        "int[2]", "int const[2]", "int(*)[2]", "int(* const)[2]", "int const(*)[2]", "int const(* const)[2]",
+        "void()", "void(*)()", "void(* const)()",
+    };
+
+    const char* const kernelNames[] = { "scalar", "sse4.1", "avx2" };
+}
+
+int main() {
+    using namespace ttd;
+
+    TypeTable types;
+    DeductionEngine engine(types);
+    PackedTypeCodec codec(types);
+
+    // Every spelling as an lvalue and as an xvalue, repeated to a large batch.
+    std::size_t const count = 1 << 20;
+    std::vector<const Type*> args(count);
+    std::vector<PackedType> packedArgs(count);
+    std::vector<ValueCategory> categories(count);
+    std::size_t const shapes = sizeof(spellings) / sizeof(spellings[0]);
+    for (std::size_t i = 0; i < count; ++i) {
+        args[i] = parseType(spellings[i % shapes], types);
+        packedArgs[i] = codec.pack(args[i]);
+        categories[i] = (i / shapes) % 2 == 0 ? ValueCategory::lvalue : ValueCategory::xvalue;
+    }
+
+    std::vector<PackedType> params(count);
+    std::vector<PackedType> Ts(count);
+    std::vector<DeductionResult> results(count);
+    int const rounds = 20;
+    std::size_t sink = 0;
+
+    auto pairsPerSecond = [&](auto&& deduceAll) {
+        auto const start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (std::size_t form = 0; form < deductionFormCount; ++form) {
+                deduceAll(static_cast<DeductionForm>(form));
+            }
+        }
+        auto const stop = std::chrono::steady_clock::now();
+        return double(count) * rounds * deductionFormCount / std::chrono::duration<double>(stop - start).count();
+    };
+
+    double const engineRate = pairsPerSecond([&](DeductionForm form) {
+        for (std::size_t i = 0; i < count; ++i) {
+            sink += engine.deduce(args[i], categories[i], form).viable();
+        }
+    });
+    std::printf("engine (memoized):  %14.0f pairs/s\n", engineRate);
+
+    for (BatchKernel kernel : { BatchKernel::scalar, BatchKernel::sse41, BatchKernel::avx2 }) {
+        if (!batchKernelSupported(kernel)) {
+            std::printf("%-19s %14s\n", kernelNames[static_cast<int>(kernel)], "unsupported");
+            continue;
+        }
+        double const rate = pairsPerSecond([&](DeductionForm form) {
+            deduceBatch(kernel, form, packedArgs.data(), categories.data(), count, params.data(), Ts.data());
+            sink += params[count - 1];
+        });
+        std::printf("%-19s %14.0f pairs/s (%.1fx)\n", kernelNames[static_cast<int>(kernel)], rate, rate / engineRate);
+    }
+
+    // The model-type path, packing and unpacking included; bounded by the
+    // codec's lookups, not by the kernel.
+    double const mixedRate = pairsPerSecond([&](DeductionForm form) {
+        deduceBatch(engine, codec, form, args.data(), categories.data(), count, results.data());
+        sink += results[count - 1].viable();
+    });
+    std::printf("model types:        %14.0f pairs/s\n", mixedRate);
+
+    return sink == 0;
+}
@@ -0,0 +1,342 @@
+// Code size of the passBy* forms: the seven templates they used to be against
+// the single DeductionProbe in ttd.hpp.
+//
+// A consumer calls every form on a dozen pointer and array variables, which
+// all seven deduce for, and keeps the results. It is compiled once per
+// compiler, name backend and variant:
+//   seven templates   passByValue ... passByCRRef as separate function
+//                     templates with the names generated inline, as they
+//                     were before DeductionProbe (kept here as text)
+//   DeductionProbe    ttd.hpp, and pass_by.hpp for the boost and native
+//                     backends
+// and the table shows
+//   instantiations    function template specializations emitted at -O0,
+//                     where every one that is used gets a body: defined weak
+//                     symbols with template arguments, from nm
+//   text              bytes in .text and .text.* sections, with --flags
+//   symbols           defined symbols, with --flags
+//
+//   bloat-bench [--compiler CXX]... [--work DIR] [--include DIR]...
+//               [--flags "..."] [--csv]
+//
+// Defaults: g++ and clang++ (those that run), -Os as in an embedded build.
+// nm and size come from binutils.
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../tool_support.hpp"
+
+namespace {
+    using namespace ttd::tools;
+
+    const char* const variables[] = {
+        "int* pa", "int const* cpa", "int const* const pca", "long* pl", "char const* text",
+        "int as[2]", "int const cas[2]", "double ds[4]", "int (*pas)[2]", "int const (* const cpcas)[2]",
+        "int (&ras)[2]", "unsigned (*pus)[3]",
+    };
+
+    const char* const forms[] = {
+        "passByValue(%)", "passByRef(%)", "passByURef(%)", "passByPtr(%)",
+        "passByCPtr(%)", "passByCRef(%)", "passByCRRef(std::move(%))",
+    };
+
+    // The passBy* templates before DeductionProbe, on top of a typeName.
+    const char* const sevenTemplates =
+        "struct TemplateTypeInfos {\n"
+        "    std::string_view param;\n"
+        "    std::string_view T;\n"
+        "};\n"
+        "\n"
+        "template <typename T>\n"
+        "std::string_view typeName();\n"
+        "\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByValue(T t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByRef(T& t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByURef(T&& t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByPtr(T* t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByCPtr(T const* t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByCRef(T const& t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "template <typename T>\n"
+        "TemplateTypeInfos passByCRRef(T const&& t) { return { typeName<decltype(t)>(), typeName<T>() }; }\n"
+        "\n";
+
+    struct Backend {
+        const char* name;
+        const char* before;     // the names as they were, then sevenTemplates
+        const char* after;
+    };
+
+    const Backend backends[] = {
+        {
+            "constexpr",
+            "#include \"type_name.hpp\"\n"
+            "%\n"
+            "template <typename T>\n"
+            "std::string_view typeName() { return ttd::constexprTypeName<T>(); }\n",
+            "#include \"ttd.hpp\"\n",
+        },
+        {
+            "boost",
+            "#include <string>\n"
+            "#include <boost/type_index.hpp>\n"
+            "#include \"demangled_type_name.hpp\"\n"
+            "%\n"
+            "template <typename T>\n"
+            "std::string_view scrubbedPrettyName() {\n"
+            "    std::string name = boost::typeindex::type_id_with_cvr<T>().pretty_name();\n"
+            "    name.resize(ttd::scrubTypeName(&name[0], name.size()));\n"
+            "    return ttd::internTypeName(name);\n"
+            "}\n"
+            "\n"
+            "template <typename T>\n"
+            "std::string_view typeName() {\n"
+            "    static const std::string_view name = scrubbedPrettyName<T>();\n"
+            "    return name;\n"
+            "}\n",
+            "#define ENABLE_BOOST\n"
+            "#include \"pass_by.hpp\"\n",
+        },
+        {
+            "native",
+            "#include \"demangled_type_name.hpp\"\n"
+            "%\n"
+            "template <typename T>\n"
+            "std::string_view demangledName() {\n"
+            "    std::string_view const wrapped = ttd::detail::demangle(typeid(ttd::detail::CvrTag<T>).name());\n"
+            "    std::size_t const open = wrapped.find('<');\n"
+            "    std::size_t const close = wrapped.rfind('>');\n"
+            "    if (open == std::string_view::npos || close == std::string_view::npos || close <= open) {\n"
+            "        return std::string_view();\n"
+            "    }\n"
+            "    char* const name = const_cast<char*>(wrapped.data()) + open + 1;\n"
+            "    return std::string_view(name, ttd::scrubTypeName(name, close - open - 1));\n"
+            "}\n"
+            "\n"
+            "template <typename T>\n"
+            "std::string_view typeName() {\n"
+            "    static const std::string_view name = ttd::internTypeName(demangledName<T>());\n"
+            "    return name;\n"
+            "}\n",
+            "#include \"pass_by.hpp\"\n",
+        },
+    };
+
+    struct Options {
+        std::vector<std::string> compilers;
+        std::vector<std::string> includes;
+        std::string work = "bloat-bench";
+        std::string flags = "-Os";
+        bool csv = false;
+    };
+
+    struct Measurement {
+        bool ok = false;
+        long instantiations = -1;
+        long textBytes = -1;
+        long symbols = -1;
+    };
+
+    std::string replaceAll(std::string text, char marker, const std::string& with) {
+        for (std::size_t at = text.find(marker); at != std::string::npos; at = text.find(marker, at + with.size())) {
+            text.replace(at, 1, with);
+        }
+        return text;
+    }
+
+    // The name of the variable a declaration declares.
+    std::string declaredName(std::string_view declaration) {
+        std::size_t end = declaration.find(')');
+        end = end == std::string_view::npos ? declaration.find('[') : end;
+        end = end == std::string_view::npos ? declaration.size() : end;
+        std::size_t begin = end;
+        while (begin > 0 && (std::isalnum(static_cast<unsigned char>(declaration[begin - 1])) || declaration[begin - 1] == '_')) {
+            --begin;
+        }
+        return std::string(declaration.substr(begin, end - begin));
+    }
+
+    std::string generate(const Backend& backend, bool before) {
+        std::string tu = "#include <string_view>\n#include <utility>\n";
+        tu += before ? replaceAll(backend.before, '%', std::string("\n") + sevenTemplates) : backend.after;
+        tu += "\n";
+        for (const char* variable : variables) {
+            tu += std::string("extern ") + variable + ";\n";
+        }
+        tu += "\nvoid runCases(TemplateTypeInfos* infos) {\n";
+        std::size_t i = 0;
+        for (const char* variable : variables) {
+            std::string const name = declaredName(variable);
+            for (const char* form : forms) {
+                tu += "    infos[" + std::to_string(i++) + "] = " + replaceAll(form, '%', name) + ";\n";
+            }
+        }
+        tu += "}\n";
+        return tu;
+    }
+
+    // nm -C lines are "address type name". Weak definitions are W or V, and
+    // of those the functions of a template have a '<' and a parameter list.
+    long countInstantiations(const std::string& object) {
+        long count = 0;
+        bool const ok = forEachOutputLine({ "nm", "-C", "--defined-only", object }, object + ".nm", [&](std::string_view line) {
+            std::size_t const type = line.find(' ');
+            if (type == std::string_view::npos || type + 3 > line.size() || (line[type + 1] != 'W' && line[type + 1] != 'V')) {
+                return;
+            }
+            std::string_view const name = line.substr(type + 3);
+            count += name.find('<') != std::string_view::npos && name.find('(') != std::string_view::npos;
+        });
+        return ok ? count : -1;
+    }
+
+    // size -A lines are "section size address".
+    long textBytes(const std::string& object) {
+        long bytes = 0;
+        bool const ok = forEachOutputLine({ "size", "-A", object }, object + ".size", [&](std::string_view line) {
+            if (line == ".text" || line.substr(0, 6) == ".text " || line.substr(0, 6) == ".text.") {
+                bytes += std::strtol(std::string(line.substr(line.find(' '))).c_str(), nullptr, 10);
+            }
+        });
+        return ok ? bytes : -1;
+    }
+
+    long countSymbols(const std::string& object) {
+        long count = 0;
+        bool const ok = forEachOutputLine({ "nm", "--defined-only", object }, object + ".nm", [&](std::string_view) { ++count; });
+        return ok ? count : -1;
+    }
+
+    Measurement measure(const Options& options, const std::string& compiler, const std::string& source, const std::string& stem) {
+        std::vector<std::string> argv = { compiler, "-std=c++20", "-c", source, "-I", TTD_SOURCE_DIR };
+        for (const std::string& dir : options.includes) {
+            argv.push_back("-I");
+            argv.push_back(dir);
+        }
+
+        Measurement m;
+        std::vector<std::string> unoptimized = argv;
+        unoptimized.insert(unoptimized.end(), { "-O0", "-o", stem + "_O0.o" });
+        if (!run(unoptimized, stem + "_O0.log")) {
+            return m;
+        }
+        for (const std::string& flag : split(options.flags, ' ')) {
+            argv.push_back(flag);
+        }
+        argv.insert(argv.end(), { "-o", stem + ".o" });
+        if (!run(argv, stem + ".log")) {
+            return m;
+        }
+        m.ok = true;
+        m.instantiations = countInstantiations(stem + "_O0.o");
+        m.textBytes = textBytes(stem + ".o");
+        m.symbols = countSymbols(stem + ".o");
+        return m;
+    }
+
+    bool available(const std::string& compiler) {
+        return run({ compiler, "--version" }, "/dev/null");
+    }
+
+    std::string number(long value) {
+        return value < 0 ? "-" : std::to_string(value);
+    }
+
+    std::string change(long before, long after) {
+        if (before <= 0 || after < 0) {
+            return "-";
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%+.0f%%", 100.0 * (after - before) / before);
+        return text;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (arg == "--compiler" && hasValue) {
+                options.compilers.push_back(argv[++i]);
+            } else if (arg == "--include" && hasValue) {
+                options.includes.push_back(argv[++i]);
+            } else if (arg == "--work" && hasValue) {
+                options.work = argv[++i];
+            } else if (arg == "--flags" && hasValue) {
+                options.flags = argv[++i];
+            } else if (arg == "--csv") {
+                options.csv = true;
+            } else {
+                return false;
+            }
+        }
+        if (options.compilers.empty()) {
+            options.compilers = { "g++", "clang++" };
+        }
+        for (const std::string& dir : split(TTD_BOOST_INCLUDE_DIRS, ';')) {
+            options.includes.push_back(dir);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--compiler CXX]... [--work DIR] [--include DIR]... [--flags \"...\"] [--csv]\n", argv[0]);
+        return 1;
+    }
+    ::mkdir(options.work.c_str(), 0755);
+
+    const char* const header = "%-10s %-10s %-16s %15s %8s %8s %8s %8s\n";
+    const char* const row = options.csv ? "%s,%s,%s,%s,%s,%s,%s,%s\n" : header;
+    std::printf(row, "compiler", "backend", "variant", "instantiations", "change", "text B", "change", "symbols");
+
+    bool failed = false;
+    for (const std::string& compiler : options.compilers) {
+        if (!available(compiler)) {
+            std::fprintf(stderr, "skipping %s: not found\n", compiler.c_str());
+            continue;
+        }
+        std::string compilerStem = compiler;
+        for (char& c : compilerStem) {
+            c = c == '/' || c == '+' ? '_' : c;
+        }
+        for (const Backend& backend : backends) {
+            Measurement before;
+            for (bool const isBefore : { true, false }) {
+                const char* const variant = isBefore ? "seven templates" : "DeductionProbe";
+                std::string const stem = options.work + "/" + backend.name + (isBefore ? "_before" : "_after");
+                std::string const source = stem + ".cpp";
+                std::ofstream(source) << generate(backend, isBefore);
+
+                Measurement const m = measure(options, compiler, source, stem + "_" + compilerStem);
+                if (!m.ok) {
+                    std::fprintf(stderr, "%s failed on %s, see %s_%s*.log\n", compiler.c_str(), source.c_str(), stem.c_str(), compilerStem.c_str());
+                    failed = true;
+                    continue;
+                }
+                if (isBefore) {
+                    before = m;
+                }
+                std::printf(row, compiler.c_str(), backend.name, variant, number(m.instantiations).c_str(),
+                            isBefore ? "" : change(before.instantiations, m.instantiations).c_str(), number(m.textBytes).c_str(),
+                            isBefore ? "" : change(before.textBytes, m.textBytes).c_str(), number(m.symbols).c_str());
+                std::fflush(stdout);
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
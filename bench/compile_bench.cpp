@@ -0,0 +1,300 @@
+// Compile-time scaling of deduction cases.
+//
+// Generates translation units with N cases each, every one printing a
+// variable's type and a deduction on it, over declarators deeper than the
+// report's (pointers to arrays of pointers, references to multi-dimensional
+// arrays, pointers to functions taking arrays), every case a distinct type so
+// every case instantiates anew. Each TU is compiled once per compiler and
+// name backend, and the table shows how compile time, peak RSS, object size,
+// emitted symbols and template instantiations grow with N.
+//
+//   compile-bench [--compiler CXX]... [--cases N]... [--work DIR]
+//                 [--include DIR]... [--flags "..."] [--csv]
+//
+// Defaults: g++ and clang++ (those that run), N = 10, 100, 1000 and 10000.
+// Clang is given -ftime-trace and reports instantiation counts and time; GCC
+// is given -ftime-report and reports instantiation time only.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../tool_support.hpp"
+
+namespace {
+    using namespace ttd::tools;
+
+    // A declarator shape: `%` is the declarator-id, `#` a bound that makes
+    // the type unique. Every shape is a pointer or an array, so all seven
+    // passBy* forms deduce.
+    const char* const shapes[] = {
+        "int const (* const %)[#]",
+        "int (* const* %)[#]",
+        "int const* const (&%)[#]",
+        "char const volatile (* const* const %)[#]",
+        "long (&%)[#][2]",
+        "int const* (* %)[#]",
+        "unsigned (* const (&%)[#])[2]",
+        "void (* const* %)(int (&)[#])",
+    };
+
+    const char* const forms[] = {
+        "passByValue(%)", "passByRef(%)", "passByURef(%)", "passByPtr(%)",
+        "passByCPtr(%)", "passByCRef(%)", "passByCRRef(std::move(%))",
+    };
+
+    struct Backend {
+        const char* name;
+        const char* defines;
+    };
+
+    const Backend backends[] = {
+        { "boost", "#define ENABLE_BOOST\n" },
+        { "constexpr", "#define ENABLE_CONSTEXPR_TYPE_NAME\n" },
+        { "native", "" },
+    };
+
+    struct Options {
+        std::vector<std::string> compilers;
+        std::vector<std::size_t> cases;
+        std::vector<std::string> includes;
+        std::string work = "compile-bench";
+        std::string flags = "-O2";
+        bool csv = false;
+    };
+
+    struct Measurement {
+        bool ok = false;
+        double seconds = 0;
+        long peakKb = 0;
+        long objectBytes = 0;
+        long symbols = -1;
+        long instantiations = -1;
+        double instantiationSeconds = -1;
+    };
+
+    std::string replaceAll(std::string text, char marker, const std::string& with) {
+        for (std::size_t at = text.find(marker); at != std::string::npos; at = text.find(marker, at + with.size())) {
+            text.replace(at, 1, with);
+        }
+        return text;
+    }
+
+    std::string generate(std::size_t count, const Backend& backend) {
+        std::size_t const shapeCount = sizeof(shapes) / sizeof(shapes[0]);
+        std::size_t const formCount = sizeof(forms) / sizeof(forms[0]);
+
+        std::string tu = backend.defines;
+        tu += "#include <utility>\n#include \"pass_by.hpp\"\n\n";
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string const name = std::string("v").append(std::to_string(i));
+            std::string const bound = std::to_string(i / shapeCount + 1);
+            tu += "extern " + replaceAll(replaceAll(shapes[i % shapeCount], '%', name), '#', bound) + ";\n";
+        }
+        tu += "\nvoid runCases(ttd::OutputSink& out) {\n";
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string const name = std::string("v").append(std::to_string(i));
+            tu += "    out << typeName<decltype(" + name + ")>() << '\\n' << "
+                + replaceAll(forms[(i / shapeCount) % formCount], '%', name) + " << '\\n';\n";
+        }
+        tu += "}\n";
+        return tu;
+    }
+
+    long countDefinedSymbols(const std::string& object) {
+        long lines = 0;
+        bool const ok = forEachOutputLine({ "nm", "--defined-only", object }, object + ".nm", [&](std::string_view) { ++lines; });
+        return ok ? lines : -1;
+    }
+
+    // Clang's -ftime-trace: one event per instantiation, plus totals.
+    void readTimeTrace(const std::string& path, Measurement& m) {
+        std::string const trace = readFile(path);
+        if (trace.empty()) {
+            return;
+        }
+        m.instantiations = 0;
+        for (const char* name : { "\"name\":\"InstantiateFunction\"", "\"name\":\"InstantiateClass\"" }) {
+            for (std::size_t at = trace.find(name); at != std::string::npos; at = trace.find(name, at + 1)) {
+                ++m.instantiations;
+            }
+        }
+        m.instantiationSeconds = 0;
+        for (const char* name : { "\"name\":\"Total InstantiateFunction\"", "\"name\":\"Total InstantiateClass\"" }) {
+            std::size_t const at = trace.find(name);
+            std::size_t const object = at == std::string::npos ? at : trace.rfind('{', at);
+            std::size_t const dur = object == std::string::npos ? object : trace.find("\"dur\":", object);
+            if (dur != std::string::npos && dur < at) {
+                m.instantiationSeconds += std::strtod(trace.c_str() + dur + 6, nullptr) / 1e6;
+            }
+        }
+    }
+
+    // GCC's -ftime-report: " template instantiation : usr ( %) sys ( %) wall ( %) ..."
+    void readTimeReport(const std::string& log, Measurement& m) {
+        std::size_t const at = log.find(" template instantiation");
+        if (at == std::string::npos) {
+            return;
+        }
+        std::size_t const colon = log.find(':', at);
+        if (colon == std::string::npos) {
+            return;
+        }
+        // The wall column is the third number after the colon.
+        const char* p = log.c_str() + colon + 1;
+        double value = 0;
+        for (int i = 0; i < 3; ++i) {
+            char* end = nullptr;
+            value = std::strtod(p, &end);
+            if (end == p) {
+                return;
+            }
+            p = std::strchr(end, ')');
+            if (p == nullptr) {
+                return;
+            }
+            ++p;
+        }
+        m.instantiationSeconds = value;
+    }
+
+    Measurement compile(const Options& options, const std::string& compiler, const std::string& source, const std::string& stem) {
+        std::string const object = stem + ".o";
+        std::string const log = stem + ".log";
+        bool const clang = compiler.find("clang") != std::string::npos;
+
+        std::vector<std::string> argv = { compiler, "-std=c++20", "-c", source, "-o", object, "-I", TTD_SOURCE_DIR };
+        for (const std::string& dir : options.includes) {
+            argv.push_back("-I");
+            argv.push_back(dir);
+        }
+        for (const std::string& flag : split(options.flags, ' ')) {
+            argv.push_back(flag);
+        }
+        if (clang) {
+            argv.push_back("-ftime-trace");
+            argv.push_back("-ftime-trace-granularity=0");
+        } else {
+            argv.push_back("-ftime-report");
+        }
+
+        Measurement m;
+        Usage usage;
+        m.ok = run(argv, log, &usage);
+        m.seconds = usage.seconds;
+        m.peakKb = usage.peakKb;
+        if (!m.ok) {
+            return m;
+        }
+        struct stat status;
+        if (::stat(object.c_str(), &status) == 0) {
+            m.objectBytes = static_cast<long>(status.st_size);
+        }
+        m.symbols = countDefinedSymbols(object);
+        if (clang) {
+            readTimeTrace(stem + ".json", m);
+        } else {
+            readTimeReport(readFile(log), m);
+        }
+        return m;
+    }
+
+    bool available(const std::string& compiler) {
+        return run({ compiler, "--version" }, "/dev/null");
+    }
+
+    std::string number(long value) {
+        return value < 0 ? "-" : std::to_string(value);
+    }
+
+    std::string seconds(double value) {
+        if (value < 0) {
+            return "-";
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", value);
+        return text;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (arg == "--compiler" && hasValue) {
+                options.compilers.push_back(argv[++i]);
+            } else if (arg == "--cases" && hasValue) {
+                options.cases.push_back(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--include" && hasValue) {
+                options.includes.push_back(argv[++i]);
+            } else if (arg == "--work" && hasValue) {
+                options.work = argv[++i];
+            } else if (arg == "--flags" && hasValue) {
+                options.flags = argv[++i];
+            } else if (arg == "--csv") {
+                options.csv = true;
+            } else {
+                return false;
+            }
+        }
+        if (options.compilers.empty()) {
+            options.compilers = { "g++", "clang++" };
+        }
+        if (options.cases.empty()) {
+            options.cases = { 10, 100, 1000, 10000 };
+        }
+        for (const std::string& dir : split(TTD_BOOST_INCLUDE_DIRS, ';')) {
+            options.includes.push_back(dir);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--compiler CXX]... [--cases N]... [--work DIR] [--include DIR]... [--flags \"...\"] [--csv]\n", argv[0]);
+        return 1;
+    }
+    ::mkdir(options.work.c_str(), 0755);
+
+    const char* const header = "%-10s %-10s %7s %9s %10s %11s %9s %15s %12s\n";
+    const char* const row = options.csv ? "%s,%s,%s,%s,%s,%s,%s,%s,%s\n" : header;
+    std::printf(row, "compiler", "backend", "cases", "seconds", "peak MB", "object KB", "symbols", "instantiations", "inst seconds");
+
+    bool failed = false;
+    for (const std::string& compiler : options.compilers) {
+        if (!available(compiler)) {
+            std::fprintf(stderr, "skipping %s: not found\n", compiler.c_str());
+            continue;
+        }
+        for (const Backend& backend : backends) {
+            for (std::size_t count : options.cases) {
+                std::string const stem = options.work + "/" + backend.name + "_" + std::to_string(count);
+                std::string const source = stem + ".cpp";
+                std::ofstream(source) << generate(count, backend);
+
+                std::string compilerStem = compiler;
+                for (char& c : compilerStem) {
+                    c = c == '/' || c == '+' ? '_' : c;
+                }
+                Measurement const m = compile(options, compiler, source, stem + "_" + compilerStem);
+                if (!m.ok) {
+                    std::fprintf(stderr, "%s failed on %s, see %s_%s.log\n", compiler.c_str(), source.c_str(), stem.c_str(), compilerStem.c_str());
+                    failed = true;
+                    continue;
+                }
+                std::printf(row, compiler.c_str(), backend.name, std::to_string(count).c_str(), seconds(m.seconds).c_str(),
+                            seconds(m.peakKb / 1024.0).c_str(), seconds(m.objectBytes / 1024.0).c_str(),
+                            number(m.symbols).c_str(), number(m.instantiations).c_str(), seconds(m.instantiationSeconds).c_str());
+                std::fflush(stdout);
+            }
+        }
+    }
+    return failed ? 1 : 0;
+}
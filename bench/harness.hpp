@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// A small micro-benchmark harness.
+//
+// Each benchmark is calibrated to a batch of iterations that takes about
+// sampleSeconds, warmed up, and then timed as `repetitions` batches. A
+// benchmark reports the median, p99, minimum and mean time per iteration over
+// those batches, as a table, CSV or JSON, tagged with a label (the name
+// backend) so runs of different builds can be put side by side.
+
+namespace bench {
+    // Makes the compiler assume value is read, so the work producing it stays.
+    template <typename T>
+    inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static const void* volatile sink;
+        sink = &value;
+#endif
+    }
+
+    // Makes the compiler assume all memory is read and written.
+    inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+
+    enum class Format {
+        table,
+        csv,
+        json,
+    };
+
+    struct Options {
+        std::size_t repetitions = 100;
+        double warmupSeconds = 0.05;
+        double sampleSeconds = 0.002;
+        std::string filter;             // only benchmarks whose name contains it
+        Format format = Format::table;
+        std::string output;             // stdout if empty
+        std::string label;
+    };
+
+    struct Measurement {
+        std::string name;
+        std::uint64_t iterations;       // per repetition
+        double medianNs;
+        double p99Ns;
+        double minNs;
+        double meanNs;
+    };
+
+    // Parses --repetitions, --warmup, --sample (seconds), --filter, --format
+    // and --output. Returns false on anything else.
+    inline bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            const char* const value = argv[++i];
+            if (arg == "--repetitions") {
+                options.repetitions = std::max<std::size_t>(1, std::strtoul(value, nullptr, 10));
+            } else if (arg == "--warmup") {
+                options.warmupSeconds = std::strtod(value, nullptr);
+            } else if (arg == "--sample") {
+                options.sampleSeconds = std::strtod(value, nullptr);
+            } else if (arg == "--filter") {
+                options.filter = value;
+            } else if (arg == "--format" && std::string_view(value) == "table") {
+                options.format = Format::table;
+            } else if (arg == "--format" && std::string_view(value) == "csv") {
+                options.format = Format::csv;
+            } else if (arg == "--format" && std::string_view(value) == "json") {
+                options.format = Format::json;
+            } else if (arg == "--output") {
+                options.output = value;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    class Harness {
+    public:
+        explicit Harness(Options options) : _options(std::move(options)) { }
+
+        template <typename F>
+        void run(std::string_view name, F&& body) {
+            if (name.find(_options.filter) == std::string_view::npos) {
+                return;
+            }
+
+            // Grow the batch until it takes a sample's worth of time.
+            std::uint64_t iterations = 1;
+            for (;;) {
+                double const seconds = time(body, iterations);
+                if (seconds >= _options.sampleSeconds || iterations >= (std::uint64_t(1) << 40)) {
+                    break;
+                }
+                iterations *= seconds > 0 ? std::max<std::uint64_t>(2, std::uint64_t(_options.sampleSeconds / seconds)) : 16;
+            }
+
+            for (Clock::time_point const end = Clock::now() + toDuration(_options.warmupSeconds); Clock::now() < end;) {
+                time(body, iterations);
+            }
+
+            std::vector<double> samples(_options.repetitions);
+            for (double& sample : samples) {
+                sample = time(body, iterations) * 1e9 / double(iterations);
+            }
+            std::sort(samples.begin(), samples.end());
+
+            double sum = 0;
+            for (double sample : samples) {
+                sum += sample;
+            }
+            std::size_t const p99 = std::min(samples.size() - 1, (samples.size() * 99 + 99) / 100 - 1);
+            _results.push_back({ std::string(name), iterations, samples[samples.size() / 2], samples[p99], samples.front(), sum / double(samples.size()) });
+        }
+
+        // Writes every measurement; returns false if the output cannot be opened.
+        bool report() const {
+            std::FILE* const out = _options.output.empty() ? stdout : std::fopen(_options.output.c_str(), "w");
+            if (out == nullptr) {
+                return false;
+            }
+
+            switch (_options.format) {
+            case Format::table:
+                std::fprintf(out, "%-40s %-10s %12s %12s %12s %12s\n", "benchmark", "backend", "median ns", "p99 ns", "min ns", "iterations");
+                for (const Measurement& m : _results) {
+                    std::fprintf(out, "%-40s %-10s %12.2f %12.2f %12.2f %12llu\n", m.name.c_str(), _options.label.c_str(),
+                                 m.medianNs, m.p99Ns, m.minNs, static_cast<unsigned long long>(m.iterations));
+                }
+                break;
+            case Format::csv:
+                std::fprintf(out, "benchmark,backend,iterations,median_ns,p99_ns,min_ns,mean_ns\n");
+                for (const Measurement& m : _results) {
+                    std::fprintf(out, "%s,%s,%llu,%.3f,%.3f,%.3f,%.3f\n", m.name.c_str(), _options.label.c_str(),
+                                 static_cast<unsigned long long>(m.iterations), m.medianNs, m.p99Ns, m.minNs, m.meanNs);
+                }
+                break;
+            case Format::json:
+                std::fprintf(out, "[\n");
+                for (std::size_t i = 0; i < _results.size(); ++i) {
+                    const Measurement& m = _results[i];
+                    std::fprintf(out, "  {\"benchmark\": \"%s\", \"backend\": \"%s\", \"iterations\": %llu, "
+                                      "\"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, \"mean_ns\": %.3f}%s\n",
+                                 m.name.c_str(), _options.label.c_str(), static_cast<unsigned long long>(m.iterations),
+                                 m.medianNs, m.p99Ns, m.minNs, m.meanNs, i + 1 < _results.size() ? "," : "");
+                }
+                std::fprintf(out, "]\n");
+                break;
+            }
+
+            if (out != stdout) {
+                std::fclose(out);
+            }
+            return true;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        Options _options;
+        std::vector<Measurement> _results;
+
+        static Clock::duration toDuration(double seconds) {
+            return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        }
+
+        template <typename F>
+        static double time(F& body, std::uint64_t iterations) {
+            Clock::time_point const start = Clock::now();
+            for (std::uint64_t i = 0; i < iterations; ++i) {
+                body();
+                clobberMemory();
+            }
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+    };
+}
@@ -0,0 +1,323 @@
+// What it costs a TU to use the passBy* templates, and what the ttd library
+// saves.
+//
+// A small consumer (one passByRef call, printed with printf) is compiled
+// against each way of getting the templates:
+//   pass_by.hpp        the report's header with boost and <iostream>, which
+//                      is what a tool had to include before ttd.hpp existed
+//   pass_by.hpp, PCH   the same with those headers precompiled
+//   ttd.hpp            the lean header
+//   import ttd         the C++20 module from ttd.cppm
+// Then main.cpp, the report itself, without and with its heavy headers
+// precompiled, as ttd-pch does in the build: its rebuild time after an edit.
+//
+//   header-bench [--compiler CXX]... [--runs N] [--work DIR]
+//                [--include DIR]... [--flags "..."] [--csv]
+//
+// Setup is the one-time cost of the PCH or the module interface; compile is
+// the median of --runs builds of the TU after it; lines is the size of the
+// preprocessed TU, what the compiler parses on every build without a PCH or
+// module. Defaults: g++ and clang++ (those that run), 3 runs, -O2.
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "../tool_support.hpp"
+
+namespace {
+    using namespace ttd::tools;
+
+    const char* const consumerBody =
+        "#include <cstdio>\n"
+        "\n"
+        "int main() {\n"
+        "    int const ca[2] = {};\n"
+        "    TemplateTypeInfos const infos = passByRef(ca);\n"
+        "    std::printf(\"%.*s / %.*s\\n\", int(infos.param.size()), infos.param.data(), int(infos.T.size()), infos.T.data());\n"
+        "}\n";
+
+    const char* const passByPreamble =
+        "#define ENABLE_BOOST\n"
+        "#include <iostream>\n"
+        "#include \"pass_by.hpp\"\n";
+
+    // The headers ttd-pch precompiles for the report; keep in step with
+    // CMakeLists.txt.
+    const char* const reportHeaders =
+        "#include <algorithm>\n"
+        "#include <array>\n"
+        "#include <deque>\n"
+        "#include <fstream>\n"
+        "#include <iostream>\n"
+        "#include <memory_resource>\n"
+        "#include <string>\n"
+        "#include <string_view>\n"
+        "#include <vector>\n"
+        "\n"
+        "#include <boost/type_index.hpp>\n";
+
+    enum class Setup {
+        none,
+        pch,
+        module,
+    };
+
+    struct Variant {
+        const char* name;
+        Setup setup;
+        const char* pchHeader;      // with Setup::pch
+        std::string source;         // empty: main.cpp
+        const char* defines;        // on the command line, also for the PCH
+    };
+
+    struct Options {
+        std::vector<std::string> compilers;
+        std::vector<std::string> includes;
+        std::string work = "header-bench";
+        std::string flags = "-O2";
+        std::size_t runs = 3;
+        bool csv = false;
+    };
+
+    struct Measurement {
+        bool ok = false;
+        double setupSeconds = -1;
+        double seconds = 0;
+        long peakKb = 0;
+        long lines = -1;
+    };
+
+    long countLines(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        long lines = 0;
+        for (char c; in.get(c);) {
+            lines += c == '\n';
+        }
+        return lines;
+    }
+
+    class Bench {
+    public:
+        Bench(const Options& options, std::string compiler, std::string work)
+            : _options(options), _compiler(std::move(compiler)), _work(std::move(work)),
+              _clang(_compiler.find("clang") != std::string::npos) { }
+
+        Measurement measure(const Variant& variant, const std::string& stem) {
+            Measurement m;
+            std::string const source = variant.source.empty() ? std::string(TTD_SOURCE_DIR) + "/main.cpp" : _work + "/" + stem + ".cpp";
+            if (!variant.source.empty()) {
+                std::ofstream(source) << variant.source;
+            }
+
+            std::vector<std::string> extra = split(variant.defines, ' ');
+            if (variant.setup == Setup::pch) {
+                if (!buildPch(variant, stem, extra, m.setupSeconds)) {
+                    return m;
+                }
+            } else if (variant.setup == Setup::module) {
+                if (!buildModule(stem, m.setupSeconds)) {
+                    return m;
+                }
+                for (const std::string& flag : moduleFlags()) {
+                    extra.push_back(flag);
+                }
+            } else {
+                std::vector<std::string> preprocess = command(extra);
+                preprocess.insert(preprocess.end(), { "-E", source, "-o", _work + "/" + stem + ".i" });
+                if (run(preprocess, _work + "/" + stem + ".log", nullptr, _work)) {
+                    m.lines = countLines(_work + "/" + stem + ".i");
+                }
+            }
+
+            std::vector<std::string> argv = command(extra);
+            argv.insert(argv.end(), { "-c", source, "-o", _work + "/" + stem + ".o" });
+            std::vector<double> times;
+            for (std::size_t i = 0; i < _options.runs; ++i) {
+                Usage usage;
+                if (!run(argv, _work + "/" + stem + ".log", &usage, _work)) {
+                    return m;
+                }
+                times.push_back(usage.seconds);
+                m.peakKb = std::max(m.peakKb, usage.peakKb);
+            }
+            std::sort(times.begin(), times.end());
+            m.seconds = times[times.size() / 2];
+            m.ok = true;
+            return m;
+        }
+
+    private:
+        std::vector<std::string> command(const std::vector<std::string>& extra) const {
+            std::vector<std::string> argv = { _compiler, "-std=c++20", "-I", TTD_SOURCE_DIR };
+            for (const std::string& dir : _options.includes) {
+                argv.push_back("-I");
+                argv.push_back(dir);
+            }
+            for (const std::string& flag : split(_options.flags, ' ')) {
+                argv.push_back(flag);
+            }
+            argv.insert(argv.end(), extra.begin(), extra.end());
+            return argv;
+        }
+
+        // Precompiles the variant's header, and has extra use it.
+        bool buildPch(const Variant& variant, const std::string& stem, std::vector<std::string>& extra, double& seconds) {
+            std::string const header = _work + "/" + stem + "_pch.hpp";
+            std::string const pch = header + (_clang ? ".pch" : ".gch");
+            std::ofstream(header) << variant.pchHeader;
+
+            std::vector<std::string> argv = command(extra);
+            argv.insert(argv.end(), { "-x", "c++-header", header, "-o", pch });
+            Usage usage;
+            if (!run(argv, _work + "/" + stem + "_pch.log", &usage, _work)) {
+                return false;
+            }
+            seconds = usage.seconds;
+            if (_clang) {
+                extra.insert(extra.end(), { "-include-pch", pch });
+            } else {
+                extra.insert(extra.end(), { "-include", header, "-Winvalid-pch" });
+            }
+            return true;
+        }
+
+        // The module's binary interface goes into the work directory: GCC's
+        // gcm.cache/ there, Clang's ttd.pcm.
+        bool buildModule(const std::string& stem, double& seconds) {
+            std::vector<std::string> argv = command(moduleFlags());
+            std::string const interface = std::string(TTD_SOURCE_DIR) + "/ttd.cppm";
+            if (_clang) {
+                argv.insert(argv.end(), { "-x", "c++-module", "--precompile", interface, "-o", _work + "/ttd.pcm" });
+            } else {
+                argv.insert(argv.end(), { "-x", "c++", "-c", interface, "-o", _work + "/ttd.o" });
+            }
+            Usage usage;
+            bool const built = run(argv, _work + "/" + stem + "_module.log", &usage, _work);
+            seconds = usage.seconds;
+            return built;
+        }
+
+        std::vector<std::string> moduleFlags() const {
+            if (_clang) {
+                return { "-fprebuilt-module-path=" + _work };
+            }
+            return { "-fmodules-ts" };
+        }
+
+        const Options& _options;
+        std::string _compiler;
+        std::string _work;
+        bool _clang;
+    };
+
+    bool available(const std::string& compiler) {
+        return run({ compiler, "--version" }, "/dev/null");
+    }
+
+    std::string number(long value) {
+        return value < 0 ? "-" : std::to_string(value);
+    }
+
+    std::string seconds(double value) {
+        if (value < 0) {
+            return "-";
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", value);
+        return text;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (arg == "--compiler" && hasValue) {
+                options.compilers.push_back(argv[++i]);
+            } else if (arg == "--runs" && hasValue) {
+                options.runs = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--include" && hasValue) {
+                options.includes.push_back(argv[++i]);
+            } else if (arg == "--work" && hasValue) {
+                options.work = argv[++i];
+            } else if (arg == "--flags" && hasValue) {
+                options.flags = argv[++i];
+            } else if (arg == "--csv") {
+                options.csv = true;
+            } else {
+                return false;
+            }
+        }
+        if (options.compilers.empty()) {
+            options.compilers = { "g++", "clang++" };
+        }
+        for (const std::string& dir : split(TTD_BOOST_INCLUDE_DIRS, ';')) {
+            options.includes.push_back(dir);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--compiler CXX]... [--runs N] [--work DIR] [--include DIR]... [--flags \"...\"] [--csv]\n", argv[0]);
+        return 1;
+    }
+    // The compiler runs in a directory of its own, so every path is absolute.
+    ::mkdir(options.work.c_str(), 0755);
+    char work[PATH_MAX];
+    if (::realpath(options.work.c_str(), work) == nullptr) {
+        std::fprintf(stderr, "cannot use %s\n", options.work.c_str());
+        return 1;
+    }
+
+    std::string const passBy = std::string(passByPreamble) + "\n" + consumerBody;
+    std::vector<Variant> const variants = {
+        { "pass_by.hpp", Setup::none, nullptr, passBy, "" },
+        { "pass_by.hpp, PCH", Setup::pch, passByPreamble, passBy, "" },
+        { "ttd.hpp", Setup::none, nullptr, std::string("#include \"ttd.hpp\"\n\n") + consumerBody, "" },
+        { "import ttd", Setup::module, nullptr, std::string("import ttd;\n\n") + consumerBody, "" },
+        { "main.cpp", Setup::none, nullptr, "", "-DTTD_STATS" },
+        { "main.cpp, PCH", Setup::pch, reportHeaders, "", "-DTTD_STATS" },
+    };
+
+    const char* const header = "%-10s %-18s %9s %10s %9s %9s\n";
+    const char* const row = options.csv ? "%s,%s,%s,%s,%s,%s\n" : header;
+    std::printf(row, "compiler", "consumer", "setup s", "compile s", "peak MB", "lines");
+
+    bool failed = false;
+    for (const std::string& compiler : options.compilers) {
+        if (!available(compiler)) {
+            std::fprintf(stderr, "skipping %s: not found\n", compiler.c_str());
+            continue;
+        }
+        std::string compilerStem = compiler;
+        for (char& c : compilerStem) {
+            c = c == '/' || c == '+' ? '_' : c;
+        }
+        Bench bench(options, compiler, std::string(work) + "/" + compilerStem);
+        ::mkdir((std::string(work) + "/" + compilerStem).c_str(), 0755);
+
+        for (std::size_t i = 0; i < variants.size(); ++i) {
+            std::string const stem = "variant" + std::to_string(i);
+            Measurement const m = bench.measure(variants[i], stem);
+            if (!m.ok) {
+                std::fprintf(stderr, "%s failed on %s, see %s/%s/%s*.log\n", compiler.c_str(), variants[i].name, work,
+                             compilerStem.c_str(), stem.c_str());
+                failed = true;
+                continue;
+            }
+            std::printf(row, compiler.c_str(), variants[i].name, seconds(m.setupSeconds).c_str(), seconds(m.seconds).c_str(),
+                        seconds(m.peakKb / 1024.0).c_str(), number(m.lines).c_str());
+        }
+    }
+    return failed ? 1 : 0;
+}
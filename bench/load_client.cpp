@@ -0,0 +1,242 @@
+// Load generator for ttd-server.
+//
+//   ttd-load <socket path> [--connections N] [--threads N] [--batch N] [--seconds N]
+//
+// Every connection runs closed loop: it writes a batch of queries, waits for
+// all of their answers and measures the round trip, then sends the next batch.
+// The connections are spread over the threads, each of which drives its share
+// through one epoll loop. Reports queries per second and round-trip latency
+// percentiles.
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../deduction_form.hpp"
+#include "../value_category.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const char* const types[] = {
+        "int", "int*", "int&", "int&&", "int const", "int const*", "int const* const", "int const&",
+        "int[2]", "int const[2]", "int(*)[2]", "int(* const)[2]", "int const(*)[2]", "int(&)[2]",
+        "void()", "void(*)()", "void(* const)()", "void(&)()",
+    };
+
+    struct Options {
+        const char* path = nullptr;
+        std::size_t connections = 1000;
+        std::size_t threads = 4;
+        std::size_t batch = 16;
+        double seconds = 5;
+    };
+
+    struct Client {
+        int fd = -1;
+        std::string request;
+        std::size_t sent = 0;
+        std::size_t answersLeft = 0;
+        Clock::time_point start;
+    };
+
+    struct ThreadResult {
+        std::vector<std::uint32_t> latencies;   // nanoseconds per batch
+        std::uint64_t queries = 0;
+        std::uint64_t errors = 0;
+    };
+
+    std::string makeBatch(std::size_t seed, std::size_t batch) {
+        std::string request;
+        std::size_t const typeCount = sizeof(types) / sizeof(types[0]);
+        for (std::size_t i = 0; i < batch; ++i) {
+            std::size_t const n = seed * batch + i;
+            request += ttd::valueCategoryNames[n % 2];
+            request += ' ';
+            request += ttd::deductionFormNames[(n / 2) % ttd::deductionFormCount];
+            request += ' ';
+            request += types[(n / 2 / ttd::deductionFormCount) % typeCount];
+            request += '\n';
+        }
+        return request;
+    }
+
+    int connectTo(const char* path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+        int const fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 && errno != EINPROGRESS) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Sends what is left of the current batch; false on a broken connection.
+    bool flush(Client& client) {
+        while (client.sent < client.request.size()) {
+            ssize_t const sent = ::send(client.fd, client.request.data() + client.sent,
+                                        client.request.size() - client.sent, MSG_NOSIGNAL);
+            if (sent < 0) {
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            }
+            client.sent += static_cast<std::size_t>(sent);
+        }
+        return true;
+    }
+
+    void drive(const Options& options, std::size_t count, std::size_t seed,
+               const std::atomic<bool>& running, ThreadResult& result) {
+        int const epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        std::vector<Client> clients(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            Client& client = clients[i];
+            client.fd = connectTo(options.path);
+            if (client.fd < 0) {
+                ++result.errors;
+                continue;
+            }
+            client.request = makeBatch(seed + i, options.batch);
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = &client;
+            ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &event);
+
+            client.answersLeft = options.batch;
+            client.start = Clock::now();
+            if (!flush(client)) {
+                ++result.errors;
+            }
+        }
+
+        std::vector<epoll_event> events(256);
+        char buffer[64 * 1024];
+        while (running.load(std::memory_order_relaxed)) {
+            int const ready = ::epoll_wait(epollFd, events.data(), int(events.size()), 100);
+            for (int i = 0; i < ready; ++i) {
+                Client& client = *static_cast<Client*>(events[i].data.ptr);
+                if (!flush(client)) {
+                    ++result.errors;
+                    continue;
+                }
+                ssize_t const received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+                if (received <= 0) {
+                    if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                        ::epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+                        ++result.errors;
+                    }
+                    continue;
+                }
+                for (ssize_t j = 0; j < received; ++j) {
+                    if (buffer[j] == '?') {
+                        ++result.errors;
+                    }
+                    if (buffer[j] == '\n' && --client.answersLeft == 0) {
+                        Clock::time_point const now = Clock::now();
+                        result.latencies.push_back(static_cast<std::uint32_t>(
+                            std::min<std::int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.start).count(), UINT32_MAX)));
+                        result.queries += options.batch;
+                        client.answersLeft = options.batch;
+                        client.sent = 0;
+                        client.start = now;
+                        if (!flush(client)) {
+                            ++result.errors;
+                        }
+                    }
+                }
+            }
+        }
+
+        for (Client& client : clients) {
+            if (client.fd >= 0) {
+                ::close(client.fd);
+            }
+        }
+        ::close(epollFd);
+    }
+
+    double percentile(const std::vector<std::uint32_t>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0;
+        }
+        std::size_t const index = std::min(sorted.size() - 1, static_cast<std::size_t>(p * double(sorted.size())));
+        return sorted[index] / 1000.0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        bool const hasValue = i + 1 < argc;
+        if (arg == "--connections" && hasValue) {
+            options.connections = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--batch" && hasValue) {
+            options.batch = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--seconds" && hasValue) {
+            options.seconds = std::strtod(argv[++i], nullptr);
+        } else if (options.path == nullptr && !arg.empty() && arg[0] != '-') {
+            options.path = argv[i];
+        } else {
+            options.path = nullptr;
+            break;
+        }
+    }
+    if (options.path == nullptr) {
+        std::fprintf(stderr, "usage: %s <socket path> [--connections N] [--threads N] [--batch N] [--seconds N]\n", argv[0]);
+        return 1;
+    }
+
+    std::atomic<bool> running{ true };
+    std::vector<ThreadResult> results(options.threads);
+    std::vector<std::thread> threads;
+    Clock::time_point const start = Clock::now();
+    for (std::size_t t = 0; t < options.threads; ++t) {
+        std::size_t const count = options.connections / options.threads + (t < options.connections % options.threads ? 1 : 0);
+        threads.emplace_back(drive, std::cref(options), count, t * options.connections, std::cref(running), std::ref(results[t]));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    running = false;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double const elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<std::uint32_t> latencies;
+    std::uint64_t queries = 0;
+    std::uint64_t errors = 0;
+    for (ThreadResult& result : results) {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        queries += result.queries;
+        errors += result.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    std::printf("connections:   %zu over %zu threads, %zu queries per batch\n", options.connections, options.threads, options.batch);
+    std::printf("throughput:    %.0f queries/s (%.0f batches/s)\n", double(queries) / elapsed, double(latencies.size()) / elapsed);
+    std::printf("batch latency: p50 %.1f us, p90 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+                percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99),
+                percentile(latencies, 0.999), latencies.empty() ? 0.0 : latencies.back() / 1000.0);
+    std::printf("errors:        %llu\n", static_cast<unsigned long long>(errors));
+    return errors == 0 ? 0 : 1;
+}
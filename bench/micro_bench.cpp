@@ -0,0 +1,115 @@
+// Micro-benchmarks of the report's hot path.
+//
+// End to end, every passBy* template on a representative argument. Then the
+// parts separately: boost's pretty_name(), the native demangler, the old
+// std::regex remove__ptr64 and the in-place scrubber that replaced it, the
+// name backends, and TemplateTypeInfos through both operator<< overloads.
+//
+// The build decides the name backend the passBy* templates use (see
+// CMakeLists.txt), and the backend goes into every output row, so CSV or JSON
+// from micro-bench, micro-bench-boost and micro-bench-native can be diffed
+// directly.
+//
+//   micro-bench [--format table|csv|json] [--output FILE] [--filter TEXT]
+//               [--repetitions N] [--warmup SECONDS] [--sample SECONDS]
+
+#include <cstdio>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "../output_sink.hpp"
+#include "../pass_by.hpp"
+#include "harness.hpp"
+
+namespace {
+    std::string remove__ptr64(const std::string& s) {
+        std::regex re(R"(\b(__ptr64)\b)");
+        return std::regex_replace(s, re, "");
+    }
+
+    const char* const msvcName = "int const (* __ptr64 const & __ptr64)[2]";
+}
+
+int main(int argc, char* argv[]) {
+    bench::Options options;
+#if defined(ENABLE_CONSTEXPR_TYPE_NAME)
+    options.label = "constexpr";
+#elif defined(ENABLE_BOOST)
+    options.label = "boost";
+#else
+    options.label = "native";
+#endif
+    if (!bench::parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--format table|csv|json] [--output FILE] [--filter TEXT] "
+                             "[--repetitions N] [--warmup SECONDS] [--sample SECONDS]\n", argv[0]);
+        return 1;
+    }
+    bench::Harness harness(options);
+
+    int a = 27;
+    int const ca = a;
+    int as[2] = { 1, 2 };
+    int const* cpa = &a;
+    void (*fp)() = nullptr;
+
+    // The results are kept, so the calls and the name lookups stay.
+    harness.run("passByValue(int)", [&] { bench::doNotOptimize(passByValue(a)); });
+    harness.run("passByValue(int[2])", [&] { bench::doNotOptimize(passByValue(as)); });
+    harness.run("passByRef(int const)", [&] { bench::doNotOptimize(passByRef(ca)); });
+    harness.run("passByRef(int[2])", [&] { bench::doNotOptimize(passByRef(as)); });
+    harness.run("passByURef(int)", [&] { bench::doNotOptimize(passByURef(a)); });
+    harness.run("passByURef(int&&)", [&] { bench::doNotOptimize(passByURef(std::move(a))); });
+    harness.run("passByPtr(int const*)", [&] { bench::doNotOptimize(passByPtr(cpa)); });
+    harness.run("passByPtr(void(*)())", [&] { bench::doNotOptimize(passByPtr(fp)); });
+    harness.run("passByCPtr(int const*)", [&] { bench::doNotOptimize(passByCPtr(cpa)); });
+    harness.run("passByCRef(int[2])", [&] { bench::doNotOptimize(passByCRef(as)); });
+    harness.run("passByCRRef(int const&&)", [&] { bench::doNotOptimize(passByCRRef(std::move(ca))); });
+
+#ifdef ENABLE_BOOST
+    harness.run("type_id_with_cvr::pretty_name", [] {
+        bench::doNotOptimize(boost::typeindex::type_id_with_cvr<int const(* const&)[2]>().pretty_name());
+    });
+#endif
+
+    harness.run("demangledTypeName (uncached)", [] {
+        bench::doNotOptimize(ttd::demangledTypeName<int const(* const&)[2]>());
+    });
+
+    harness.run("remove__ptr64 (std::regex)", [] {
+        bench::doNotOptimize(remove__ptr64(msvcName));
+    });
+
+    std::string const scrubInput = msvcName;
+    std::string scrubBuffer = scrubInput;
+    harness.run("scrubTypeName", [&] {
+        scrubBuffer.assign(scrubInput);
+        bench::doNotOptimize(ttd::scrubTypeName(&scrubBuffer[0], scrubBuffer.size()));
+    });
+
+    harness.run("constexprTypeName", [] {
+        bench::doNotOptimize(ttd::constexprTypeName<int const(* const&)[2]>());
+    });
+
+    harness.run("typeName (cached)", [] {
+        bench::doNotOptimize(typeName<int const(* const&)[2]>());
+    });
+
+    TemplateTypeInfos const infos = passByCRef(as);
+    ttd::MemorySink sink;
+    harness.run("operator<<(OutputSink&)", [&] {
+        sink.clear();
+        sink << infos;
+        bench::doNotOptimize(sink.str().data());
+    });
+
+    std::ostringstream stream;
+    harness.run("operator<<(std::ostream&)", [&] {
+        stream.str(std::string());
+        stream << infos;
+        bench::doNotOptimize(stream);
+    });
+
+    return harness.report() ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// Throughput of the declarator parser over a generated corpus.
+//
+// The corpus mixes the shapes the report prints with deeper ones: chains of
+// pointers, arrays and functions, optionally under a reference, spelled east
+// and west const, with and without blanks.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../type_parser.hpp"
+
+namespace {
+    std::string generateDeclarator(std::mt19937& rng) {
+        static const char* const bases[] = { "int", "char", "unsigned long", "double", "void", "std::string" };
+        auto pick = [&](int n) { return static_cast<int>(rng() % static_cast<unsigned>(n)); };
+
+        bool const eastConst = pick(2) == 0;
+        bool const spaced = pick(2) == 0;
+        const char* const base = bases[pick(6)];
+        bool const voidBase = std::string_view(base) == "void";
+        bool const constBase = pick(2) == 0;
+
+        // The declarator is built from the base type outwards. It is kept as
+        // the text left and right of where a declarator-id would go; a prefix
+        // operator next to a suffix needs parentheses.
+        std::string left;
+        std::string right;
+        bool arrayOrFunction = false;
+        bool function = false;
+        auto prefix = [&](const std::string& op) {
+            if (!right.empty() && (right[0] == '[' || right[0] == '(')) {
+                left += "(";
+                right = ")" + right;
+            }
+            left += op;
+        };
+        auto pointer = [&] {
+            prefix(pick(2) ? "*" : (spaced ? "* const " : "* const"));
+            arrayOrFunction = false;
+            function = false;
+        };
+
+        int const layers = pick(5);
+        for (int i = 0; i < layers; ++i) {
+            switch (pick(3)) {
+            case 0:
+                pointer();
+                break;
+            case 1:
+                // There are no arrays of functions or of void.
+                if (function || (i == 0 && voidBase)) {
+                    pointer();
+                }
+                right = std::string("[").append(std::to_string(1 + pick(8))).append("]").append(right);
+                arrayOrFunction = true;
+                function = false;
+                break;
+            default:
+                // Functions cannot return arrays or functions.
+                if (arrayOrFunction) {
+                    pointer();
+                }
+                right = (pick(2) ? "()" : (spaced ? "(int, char const*)" : "(int,const char*)")) + right;
+                arrayOrFunction = true;
+                function = true;
+                break;
+            }
+        }
+        // Nor references to void.
+        if (layers == 0 && voidBase) {
+            pointer();
+        }
+        switch (pick(3)) {
+        case 0:
+            prefix("&");
+            break;
+        case 1:
+            prefix("&&");
+            break;
+        default:
+            break;
+        }
+        std::string const inner = left + right;
+
+        std::string spelling;
+        if (constBase && !eastConst) {
+            spelling += "const ";
+        }
+        spelling += base;
+        if (constBase && eastConst) {
+            spelling += " const";
+        }
+        if (spaced && !inner.empty()) {
+            spelling += ' ';
+        }
+        return spelling + inner;
+    }
+}
+
+int main() {
+    std::mt19937 rng(2024);
+    std::vector<std::string> corpus(100000);
+    std::size_t bytes = 0;
+    for (std::string& spelling : corpus) {
+        spelling = generateDeclarator(rng);
+        bytes += spelling.size();
+    }
+
+    ttd::TypeTable types;
+    std::size_t rejected = 0;
+    auto const coldStart = std::chrono::steady_clock::now();
+    for (const std::string& spelling : corpus) {
+        rejected += ttd::parseType(spelling, types) == nullptr;
+    }
+    auto const coldStop = std::chrono::steady_clock::now();
+
+    int const rounds = 20;
+    auto const warmStart = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        for (const std::string& spelling : corpus) {
+            rejected += ttd::parseType(spelling, types) == nullptr;
+        }
+    }
+    auto const warmStop = std::chrono::steady_clock::now();
+
+    double const coldSeconds = std::chrono::duration<double>(coldStop - coldStart).count();
+    double const warmSeconds = std::chrono::duration<double>(warmStop - warmStart).count();
+    double const warmNames = double(corpus.size()) * rounds;
+
+    std::printf("corpus:         %zu declarators, %zu bytes, %zu distinct types\n", corpus.size(), bytes, types.size());
+    std::printf("rejected:       %zu\n", rejected);
+    std::printf("first pass:     %12.0f names/s\n", double(corpus.size()) / coldSeconds);
+    std::printf("interned types: %12.0f names/s (%.1f MB/s)\n", warmNames / warmSeconds, double(bytes) * rounds / warmSeconds / 1e6);
+    return rejected == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+// Micro-benchmark: the scrubber against the std::regex path it replaced.
+//
+// The input is every name the deduction report prints, once as the GCC/Clang
+// demangler spells it and once as MSVC spells it (with __ptr64 and __cdecl).
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <regex>
+#include <string>
+
+#include "../scrub_type_name.hpp"
+
+static const char* const names[] = {
+    "int", "int const", "int&", "int&&", "int*", "int const&", "int const&&",
+    "int const*", "int const* const", "int const* const&", "int const* const&&",
+    "int const*&", "int const*&&", "int* const&", "int* const&&", "int*&", "int*&&",
+    "int [2]", "int const [2]", "int (&) [2]", "int (&&) [2]", "int (*) [2]",
+    "int (*&) [2]", "int (*&&) [2]", "int (* const) [2]", "int (* const&) [2]",
+    "int (* const&&) [2]", "int const (&) [2]", "int const (&&) [2]",
+    "int const (*) [2]", "int const (*&) [2]", "int const (*&&) [2]",
+    "int const (* const) [2]", "int const (* const&) [2]", "int const (* const&&) [2]",
+    "void ()", "void (&)()", "void (&&)()", "void (*)()", "void (*&)()", "void (*&&)()",
+    "void (* const)()", "void (* const&)()", "void (* const&&)()",
+
+    "int * __ptr64", "int const * __ptr64", "int const * __ptr64 const",
+    "int const * __ptr64 const & __ptr64", "int const * __ptr64 const && __ptr64",
+    "int const * __ptr64 & __ptr64", "int * __ptr64 const & __ptr64",
+    "int (& __ptr64)[2]", "int (&& __ptr64)[2]", "int (* __ptr64)[2]",
+    "int (* __ptr64 & __ptr64)[2]", "int (* __ptr64 const & __ptr64)[2]",
+    "int const (* __ptr64 const)[2]", "int const (* __ptr64 const && __ptr64)[2]",
+    "void __cdecl(void)", "void (__cdecl&)(void)", "void (__cdecl*)(void)",
+    "void (__cdecl* __ptr64 &)(void)", "void (__cdecl* __ptr64 const &)(void)",
+    "void (__cdecl* __ptr64 const &&)(void)",
+};
+
+static std::string remove__ptr64(const std::string& s) {
+    std::regex re(R"(\b(__ptr64)\b)");
+    return std::regex_replace(s, re, "");
+}
+
+template <typename F>
+static double nanosecondsPerName(int rounds, F&& scrubAll) {
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i) {
+        scrubAll();
+    }
+    auto const stop = std::chrono::steady_clock::now();
+    std::size_t const count = sizeof(names) / sizeof(names[0]);
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (double(rounds) * count);
+}
+
+int main() {
+    std::size_t sink = 0;
+
+    double const regexNs = nanosecondsPerName(200, [&] {
+        for (const char* name : names) {
+            sink += remove__ptr64(name).size();
+        }
+    });
+
+    char buffer[256];
+    double const scrubNs = nanosecondsPerName(200000, [&] {
+        for (const char* name : names) {
+            std::size_t const n = std::strlen(name);
+            std::memcpy(buffer, name, n);
+            sink += ttd::scrubTypeName(buffer, n);
+        }
+    });
+
+    std::printf("remove__ptr64 (std::regex): %10.1f ns/name\n", regexNs);
+    std::printf("scrubTypeName (in place):   %10.1f ns/name\n", scrubNs);
+    std::printf("speedup:                    %10.1fx\n", regexNs / scrubNs);
+    return sink == 0;
+}
@@ -0,0 +1,418 @@
+// Builds and runs the report's cases under every compiler and standard mode,
+// and shows where they disagree.
+//
+//   compiler-matrix [--compiler CXX]... [--std c++NN]... [--jobs N]
+//                   [--cache DIR] [--all] [--csv]
+//
+// Defaults: every g++ and clang++ on PATH (versioned names included), and
+// -std=c++11 through c++23. Each configuration compiles compiler_probe.cpp
+// and runs it; configurations are built in parallel, --jobs at a time.
+//
+// Builds are cached in DIR under a hash of the probe's sources, the
+// compiler's --version text and the flags, together with the probe's output,
+// so an unchanged configuration is neither rebuilt nor rerun. Only successes
+// are cached: a failed build leaves its log there and is tried again next
+// time, as the failure may have been the machine's rather than the code's.
+//
+// Names are parsed and printed back in ttd::printType's default style before
+// they are compared, so `const int (&)[2]` and `int const(&)[2]` agree. The
+// matrix lists the cases on which configurations disagree, or all of them
+// with --all: one column per configuration, one letter per distinct answer.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "scrub_type_name.hpp"
+#include "tool_support.hpp"
+#include "type_parser.hpp"
+#include "type_printer.hpp"
+
+namespace {
+    using namespace ttd::tools;
+
+    // Everything the probe's build depends on besides the compiler and boost.
+    const char* const probeSources[] = { "compiler_probe.cpp", "deduction_probe.hpp" };
+
+    const char* const defaultStandards[] = { "c++11", "c++14", "c++17", "c++20", "c++23" };
+
+    struct Options {
+        std::vector<std::string> compilers;
+        std::vector<std::string> standards;
+        std::size_t jobs = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+        std::string cache = "compiler-matrix-cache";
+        std::vector<std::string> includes;
+        bool all = false;
+        bool csv = false;
+    };
+
+    struct Compiler {
+        std::string command;
+        std::string version;        // first line of --version
+        std::string identity;       // --version minus the name it was run by
+    };
+
+    enum class Status {
+        built,
+        cached,
+        failed,
+    };
+
+    struct Configuration {
+        const Compiler* compiler;
+        std::string standard;
+        std::string directory;
+        Status status = Status::failed;
+        std::string output;         // the probe's, if it ran
+    };
+
+    std::uint64_t hashBytes(std::string_view bytes, std::uint64_t hash = 0xcbf29ce484222325ull) {
+        for (unsigned char byte : bytes) {
+            hash = (hash ^ byte) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    bool exists(const std::string& path) {
+        struct stat status;
+        return ::stat(path.c_str(), &status) == 0;
+    }
+
+    bool probeCompiler(const std::string& command, const std::string& scratch, Compiler& compiler) {
+        if (!run({ command, "--version" }, scratch)) {
+            return false;
+        }
+        std::string const text = readFile(scratch);
+        compiler.command = command;
+        compiler.version = text.substr(0, text.find('\n'));
+        compiler.identity = text.substr(std::min(text.size(), text.find(' ')));
+        return !text.empty();
+    }
+
+    std::vector<Compiler> findCompilers(const Options& options) {
+        std::vector<std::string> candidates = options.compilers;
+        if (candidates.empty()) {
+            candidates = { "g++", "clang++" };
+            for (int version = 4; version <= 20; ++version) {
+                candidates.push_back("g++-" + std::to_string(version));
+                candidates.push_back("clang++-" + std::to_string(version));
+            }
+        }
+
+        // g++ and g++-13 are often the same compiler; keep the first name.
+        std::vector<Compiler> compilers;
+        std::string const scratch = options.cache + "/version.txt";
+        for (const std::string& command : candidates) {
+            Compiler compiler;
+            if (!probeCompiler(command, scratch, compiler)) {
+                if (!options.compilers.empty()) {
+                    std::fprintf(stderr, "skipping %s: not found\n", command.c_str());
+                }
+                continue;
+            }
+            bool duplicate = false;
+            for (const Compiler& known : compilers) {
+                duplicate = duplicate || known.identity == compiler.identity;
+            }
+            if (!duplicate) {
+                compilers.push_back(compiler);
+            }
+        }
+        ::unlink(scratch.c_str());
+        return compilers;
+    }
+
+    std::vector<std::string> compileCommand(const Options& options, const Configuration& configuration, const std::string& binary) {
+        std::vector<std::string> argv = { configuration.compiler->command, "-std=" + configuration.standard, "-O1",
+                                          "-I", TTD_SOURCE_DIR };
+        for (const std::string& dir : options.includes) {
+            argv.push_back("-I");
+            argv.push_back(dir);
+        }
+        argv.push_back(std::string(TTD_SOURCE_DIR) + "/compiler_probe.cpp");
+        argv.push_back("-o");
+        argv.push_back(binary);
+        return argv;
+    }
+
+    std::string cacheKey(const Options& options, const Configuration& configuration, const std::string& sources) {
+        std::uint64_t hash = hashBytes(sources);
+        hash = hashBytes(configuration.compiler->identity, hash);
+        // The command line, except for where the binary goes.
+        for (const std::string& arg : compileCommand(options, configuration, "")) {
+            hash = hashBytes(arg, hashBytes(std::string_view("", 1), hash));
+        }
+        char key[17];
+        std::snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(hash));
+        return key;
+    }
+
+    // Builds and runs one configuration, unless it has a cached output.
+    void runConfiguration(const Options& options, Configuration& configuration) {
+        std::string const outputPath = configuration.directory + "/output.txt";
+        std::string const failedPath = configuration.directory + "/build.log";
+        if (exists(outputPath)) {
+            configuration.status = Status::cached;
+            configuration.output = readFile(outputPath);
+            return;
+        }
+
+        ::mkdir(configuration.directory.c_str(), 0755);
+        std::string const binary = configuration.directory + "/probe";
+        std::string const log = configuration.directory + "/build.tmp";
+        if (!run(compileCommand(options, configuration, binary), log)) {
+            ::rename(log.c_str(), failedPath.c_str());
+            configuration.status = Status::failed;
+            return;
+        }
+        ::unlink(log.c_str());
+        ::unlink(failedPath.c_str());
+
+        // Published by rename, so an interrupted run never leaves a partial
+        // entry that later runs would trust.
+        std::string const temporary = outputPath + ".tmp";
+        if (!run({ binary }, temporary) || ::rename(temporary.c_str(), outputPath.c_str()) < 0) {
+            configuration.status = Status::failed;
+            return;
+        }
+        configuration.status = Status::built;
+        configuration.output = readFile(outputPath);
+    }
+
+    // One spelling per type; a name the parser does not take is only scrubbed.
+    std::string normalize(std::string name, ttd::TypeTable& types) {
+        if (name == "!") {
+            return name;
+        }
+        if (const ttd::Type* const type = ttd::parseType(name, types)) {
+            auto const printed = ttd::printType(type);
+            if (!printed.truncated()) {
+                return std::string(printed.view());
+            }
+        }
+        name.resize(ttd::scrubTypeName(&name[0], name.size()));
+        return name;
+    }
+
+    struct Matrix {
+        std::vector<std::string> cases;                             // "<form> <argument>", in probe order
+        std::vector<std::map<std::string, std::string>> answers;    // per configuration: case -> "param / T"
+    };
+
+    Matrix collect(const std::vector<Configuration>& configurations) {
+        Matrix matrix;
+        ttd::TypeTable types;
+        std::map<std::string, bool> known;
+        for (const Configuration& configuration : configurations) {
+            std::map<std::string, std::string>& answers = matrix.answers.emplace_back();
+            for (const std::string& line : split(configuration.output, '\n')) {
+                std::vector<std::string> const fields = split(line, '\t');
+                if (fields.size() != 4) {
+                    continue;
+                }
+                std::string const name = fields[0] + " " + fields[1];
+                std::string const param = normalize(fields[2], types);
+                answers[name] = param == "!" ? "no viable deduction" : param + " / " + normalize(fields[3], types);
+                if (!known[name]) {
+                    known[name] = true;
+                    matrix.cases.push_back(name);
+                }
+            }
+        }
+        return matrix;
+    }
+
+    const char* statusName(Status status) {
+        switch (status) {
+        case Status::built:
+            return "built";
+        case Status::cached:
+            return "cached";
+        case Status::failed:
+            return "failed";
+        }
+        return "";
+    }
+
+    std::string label(const Configuration& configuration) {
+        return configuration.compiler->command + " -std=" + configuration.standard;
+    }
+
+    std::string csvField(const std::string& text) {
+        return text.find_first_of(",\"") == std::string::npos ? text : "\"" + text + "\"";
+    }
+
+    void printCsv(const std::vector<Configuration>& configurations, const Matrix& matrix) {
+        std::printf("case");
+        for (const Configuration& configuration : configurations) {
+            std::printf(",%s", csvField(label(configuration)).c_str());
+        }
+        std::printf("\n");
+        for (const std::string& name : matrix.cases) {
+            std::printf("%s", csvField(name).c_str());
+            for (const auto& answers : matrix.answers) {
+                auto const found = answers.find(name);
+                std::printf(",%s", found == answers.end() ? "" : csvField(found->second).c_str());
+            }
+            std::printf("\n");
+        }
+    }
+
+    // Returns the number of cases on which the configurations disagree.
+    std::size_t printTable(const Options& options, const std::vector<Configuration>& configurations, const Matrix& matrix) {
+        std::printf("configurations:\n");
+        for (std::size_t i = 0; i < configurations.size(); ++i) {
+            const Configuration& configuration = configurations[i];
+            std::printf("  %2zu  %-28s %-7s %s\n", i + 1, label(configuration).c_str(), statusName(configuration.status),
+                        configuration.status == Status::failed ? (configuration.directory + "/build.log").c_str()
+                                                               : configuration.compiler->version.c_str());
+        }
+
+        std::size_t width = 4;
+        for (const std::string& name : matrix.cases) {
+            width = std::max(width, name.size());
+        }
+
+        std::size_t divergent = 0;
+        bool header = false;
+        for (const std::string& name : matrix.cases) {
+            // Letters in order of first appearance; `-` where the case is missing.
+            std::vector<std::string> distinct;
+            std::string cells;
+            for (const auto& answers : matrix.answers) {
+                auto const found = answers.find(name);
+                char cell = '-';
+                if (found != answers.end()) {
+                    std::size_t index = 0;
+                    while (index < distinct.size() && distinct[index] != found->second) {
+                        ++index;
+                    }
+                    if (index == distinct.size()) {
+                        distinct.push_back(found->second);
+                    }
+                    cell = static_cast<char>('A' + std::min<std::size_t>(index, 25));
+                }
+                cells += "   ";
+                cells += cell;
+            }
+            divergent += distinct.size() > 1;
+            if (!options.all && distinct.size() <= 1) {
+                continue;
+            }
+
+            if (!header) {
+                std::printf("\n%-*s", int(width), "case");
+                for (std::size_t i = 0; i < configurations.size(); ++i) {
+                    std::printf(" %3zu", i + 1);
+                }
+                std::printf("\n");
+                header = true;
+            }
+            std::printf("%-*s%s\n", int(width), name.c_str(), cells.c_str());
+            for (std::size_t i = 0; i < distinct.size() && distinct.size() > 1; ++i) {
+                std::printf("%*s  %c: %s\n", int(width), "", static_cast<char>('A' + std::min<std::size_t>(i, 25)), distinct[i].c_str());
+            }
+        }
+
+        std::printf("\n%zu cases, %zu configurations, %zu divergent\n", matrix.cases.size(), configurations.size(), divergent);
+        return divergent;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (arg == "--compiler" && hasValue) {
+                options.compilers.push_back(argv[++i]);
+            } else if (arg == "--std" && hasValue) {
+                options.standards.push_back(argv[++i]);
+            } else if (arg == "--jobs" && hasValue) {
+                options.jobs = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--cache" && hasValue) {
+                options.cache = argv[++i];
+            } else if (arg == "--all") {
+                options.all = true;
+            } else if (arg == "--csv") {
+                options.csv = true;
+            } else {
+                return false;
+            }
+        }
+        if (options.standards.empty()) {
+            options.standards.assign(std::begin(defaultStandards), std::end(defaultStandards));
+        }
+        options.includes = split(TTD_BOOST_INCLUDE_DIRS, ';');
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: %s [--compiler CXX]... [--std c++NN]... [--jobs N] [--cache DIR] [--all] [--csv]\n", argv[0]);
+        return 1;
+    }
+    ::mkdir(options.cache.c_str(), 0755);
+
+    std::string sources;
+    for (const char* source : probeSources) {
+        std::string const text = readFile(std::string(TTD_SOURCE_DIR) + "/" + source);
+        if (text.empty()) {
+            std::fprintf(stderr, "cannot read %s/%s\n", TTD_SOURCE_DIR, source);
+            return 1;
+        }
+        sources += text;
+    }
+    for (const std::string& dir : options.includes) {
+        sources += readFile(dir + "/boost/version.hpp");
+    }
+
+    std::vector<Compiler> const compilers = findCompilers(options);
+    if (compilers.empty()) {
+        std::fprintf(stderr, "no compiler found\n");
+        return 1;
+    }
+
+    std::vector<Configuration> configurations;
+    for (const Compiler& compiler : compilers) {
+        for (const std::string& standard : options.standards) {
+            Configuration configuration;
+            configuration.compiler = &compiler;
+            configuration.standard = standard;
+            configuration.directory = options.cache + "/" + cacheKey(options, configuration, sources);
+            configurations.push_back(std::move(configuration));
+        }
+    }
+
+    // Each thread takes the next configuration until none are left.
+    std::atomic<std::size_t> next{ 0 };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < std::min(options.jobs, configurations.size()); ++i) {
+        threads.emplace_back([&] {
+            for (std::size_t index; (index = next.fetch_add(1)) < configurations.size();) {
+                runConfiguration(options, configurations[index]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    Matrix const matrix = collect(configurations);
+    if (options.csv) {
+        printCsv(configurations, matrix);
+        return 0;
+    }
+    printTable(options, configurations, matrix);
+    return 0;
+}
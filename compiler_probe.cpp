@@ -0,0 +1,124 @@
+// The deduction report's cases, portable down to C++11.
+//
+// The report needs C++20, so compiler-matrix builds this program instead to
+// compare compilers and standard modes. It runs the report's argument kinds
+// through the same passBy* probes and prints one line per case:
+//
+//   <form>\t<argument>\t<param type>\t<T>
+//
+// with `!` for the param type and T when the call does not deduce. Names are
+// boost's, unscrubbed; compiler-matrix brings them to one spelling.
+
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <boost/type_index.hpp>
+
+#include "deduction_probe.hpp"
+
+namespace {
+    // The variable `Declared x;` used by name: always an lvalue.
+    template <typename Declared>
+    struct Named {
+        typedef typename std::remove_reference<Declared>::type& expr;
+    };
+
+    // std::move(x): an xvalue, except that function expressions stay lvalues.
+    template <typename Declared>
+    struct Moved {
+        typedef typename std::remove_reference<Declared>::type&& expr;
+    };
+
+    struct NotDeducible { };
+
+#define TTD_PROBE_FORM(Form, function)                                          \
+    struct Form {                                                               \
+        static const char* name() {                                             \
+            return #function;                                                   \
+        }                                                                       \
+        template <typename Expr>                                                \
+        static decltype(ttd::probe::function(std::declval<Expr>())) deduce(int); \
+        template <typename Expr>                                                \
+        static NotDeducible deduce(...);                                        \
+    };
+
+    TTD_PROBE_FORM(PassByValue, passByValue)
+    TTD_PROBE_FORM(PassByRef, passByRef)
+    TTD_PROBE_FORM(PassByURef, passByURef)
+    TTD_PROBE_FORM(PassByPtr, passByPtr)
+    TTD_PROBE_FORM(PassByCPtr, passByCPtr)
+    TTD_PROBE_FORM(PassByCRef, passByCRef)
+    TTD_PROBE_FORM(PassByCRRef, passByCRRef)
+
+#undef TTD_PROBE_FORM
+
+    template <typename T>
+    std::string nameOf() {
+        return boost::typeindex::type_id_with_cvr<T>().pretty_name();
+    }
+
+    void printResult(const char* form, const char* arg, NotDeducible*) {
+        std::printf("%s\t%s\t!\t!\n", form, arg);
+    }
+
+    template <typename Param, typename T>
+    void printResult(const char* form, const char* arg, ttd::Deduction<Param, T>*) {
+        std::printf("%s\t%s\t%s\t%s\n", form, arg, nameOf<Param>().c_str(), nameOf<T>().c_str());
+    }
+
+    template <typename Form, typename Arg>
+    void printCase(const char* arg) {
+        typedef decltype(Form::template deduce<typename Arg::expr>(0)) Result;
+        printResult(Form::name(), arg, static_cast<Result*>(nullptr));
+    }
+
+    // In the order of ttd::ReportArguments.
+    template <typename Form>
+    void printForm() {
+#define TTD_PROBE_ARGUMENT(Declared, name)                      \
+        printCase<Form, Named<Declared> >(name);                \
+        printCase<Form, Moved<Declared> >("std::move(" name ")");
+
+        TTD_PROBE_ARGUMENT(int, "a")
+        TTD_PROBE_ARGUMENT(int*, "pa")
+        TTD_PROBE_ARGUMENT(int&, "ra")
+        TTD_PROBE_ARGUMENT(int&&, "rra")
+
+        TTD_PROBE_ARGUMENT(int const, "ca")
+        TTD_PROBE_ARGUMENT(int const*, "cpa")
+        TTD_PROBE_ARGUMENT(int const* const, "pca")
+        TTD_PROBE_ARGUMENT(int const&, "cra")
+        TTD_PROBE_ARGUMENT(int const&&, "crra")
+
+        TTD_PROBE_ARGUMENT(int[2], "as")
+        TTD_PROBE_ARGUMENT(int const[2], "cas")
+        TTD_PROBE_ARGUMENT(int(*)[2], "pas")
+        TTD_PROBE_ARGUMENT(int(* const)[2], "pcas")
+        TTD_PROBE_ARGUMENT(int const(*)[2], "cpas")
+        TTD_PROBE_ARGUMENT(int const(* const)[2], "cpcas")
+        TTD_PROBE_ARGUMENT(int(&)[2], "ras")
+        TTD_PROBE_ARGUMENT(int const(&)[2], "cras")
+        TTD_PROBE_ARGUMENT(int(&&)[2], "rras")
+        TTD_PROBE_ARGUMENT(int const(&&)[2], "crras")
+
+        TTD_PROBE_ARGUMENT(void(), "f")
+        TTD_PROBE_ARGUMENT(void(*)(), "fp")
+        TTD_PROBE_ARGUMENT(void(* const)(), "fcp")
+        TTD_PROBE_ARGUMENT(void(&)(), "fr")
+        TTD_PROBE_ARGUMENT(void(&&)(), "frr")
+
+#undef TTD_PROBE_ARGUMENT
+    }
+}
+
+int main() {
+    printForm<PassByValue>();
+    printForm<PassByRef>();
+    printForm<PassByURef>();
+    printForm<PassByPtr>();
+    printForm<PassByCPtr>();
+    printForm<PassByCRef>();
+    printForm<PassByCRRef>();
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "deduction_probe.hpp"
+
+// Probes for the deduction contexts besides function templates: auto
+// variables, decltype(auto) returns, generic lambdas, structured bindings and
+// class template argument deduction.
+//
+// Like deduction_probe.hpp, each probe names its result as
+// ttd::Deduction<declared type, T> and is only ever used in decltype, so
+// nothing here is called or emitted. The declarations are real: `auto& x =
+// e;` is compiled as written, and the compiler says what x became.
+//
+// A declaration that cannot deduce is a hard error inside a function body,
+// so the body-bound probes are guarded by a substitution that fails first.
+// Deducing auto in a declaration is the same as deducing T from a call to
+// the matching passBy* template ([dcl.type.auto.deduct]), so the guards are
+// those calls.
+
+namespace ttd {
+    namespace probe {
+        // An expression of type Expr inside a function body, where declval
+        // may not go: Expr& is an lvalue, Expr&& an xvalue. Never defined.
+        template <typename Expr>
+        Expr make();
+
+        // A variable declared as Declared, for id-expressions; never defined.
+        // A function is declared with a declarator of its own, as it must be.
+        template <typename Declared>
+        struct Declaration {
+            static Declared id;
+        };
+
+        template <typename Result, typename... Params>
+        struct Declaration<Result(Params...)> {
+            static Result id(Params...);
+        };
+
+        template <typename Function>
+        struct ReturnOf;
+
+        template <typename Result>
+        struct ReturnOf<Result(*)()> {
+            using type = Result;
+        };
+
+        // auto x = e; auto& x = e; auto&& x = e; auto const& x = e;
+        // T is what auto stands for.
+        template <typename Expr, typename = decltype(passByValue(std::declval<Expr>()))>
+        auto autoVariable() {
+            auto x = make<Expr>();
+            return Deduction<decltype(x), decltype(x)>{};
+        }
+
+        template <typename Expr, typename = decltype(passByRef(std::declval<Expr>()))>
+        auto autoRefVariable() {
+            auto& x = make<Expr>();
+            return Deduction<decltype(x), std::remove_reference_t<decltype(x)>>{};
+        }
+
+        template <typename Expr, typename = decltype(passByURef(std::declval<Expr>()))>
+        auto autoURefVariable() {
+            auto&& x = make<Expr>();
+            using T = std::conditional_t<std::is_lvalue_reference_v<decltype(x)>, decltype(x), std::remove_reference_t<decltype(x)>>;
+            return Deduction<decltype(x), T>{};
+        }
+
+        template <typename Expr, typename = decltype(passByCRef(std::declval<Expr>()))>
+        auto autoCRefVariable() {
+            auto const& x = make<Expr>();
+            return Deduction<decltype(x), std::remove_const_t<std::remove_reference_t<decltype(x)>>>{};
+        }
+
+        // decltype(auto) f() { return x; } or { return std::move(x); }. The
+        // return type is decltype of the operand, so it must be a type a
+        // function can return, and the operand must initialize it; Arg::expr
+        // is the operand's type and category. The declared return type is
+        // read off the function's type, as a call would drop the const of
+        // a non-class prvalue.
+        template <typename Arg>
+        decltype(auto) decltypeAutoReturn() {
+            if constexpr (Arg::moved) {
+                return std::move(Declaration<typename Arg::declared>::id);
+            } else {
+                return Declaration<typename Arg::declared>::id;
+            }
+        }
+
+        template <typename Result>
+        Result returned();
+
+        template <typename Result>
+        void initialize(Result);
+
+        template <typename Arg, typename Result = typename Arg::decltyped, typename = void>
+        struct DecltypeAuto { };
+
+        template <typename Arg, typename Result>
+        struct DecltypeAuto<Arg, Result,
+                            std::void_t<decltype(returned<Result>()), decltype(initialize<Result>(std::declval<typename Arg::expr>()))>> {
+            using result = typename ReturnOf<decltype(&decltypeAutoReturn<Arg>)>::type;
+            using type = Deduction<result, result>;
+        };
+
+        // [](auto p) { }, [](auto& p) { }, [](auto&& p) { }, [](auto const& p) { }
+        inline constexpr auto lambdaByValue = [](auto p) -> Deduction<decltype(p), decltype(p)> {
+            return {};
+        };
+
+        inline constexpr auto lambdaByRef = [](auto& p) -> Deduction<decltype(p), std::remove_reference_t<decltype(p)>> {
+            return {};
+        };
+
+        inline constexpr auto lambdaByURef = [](auto&& p)
+            -> Deduction<decltype(p), std::conditional_t<std::is_lvalue_reference_v<decltype(p)>, decltype(p), std::remove_reference_t<decltype(p)>>> {
+            return {};
+        };
+
+        inline constexpr auto lambdaByCRef = [](auto const& p)
+            -> Deduction<decltype(p), std::remove_const_t<std::remove_reference_t<decltype(p)>>> {
+            return {};
+        };
+
+        // auto [x, y] = e; auto& [x, y] = e; auto&& [x, y] = e; for the
+        // two-element arrays of the report, which are all it decomposes. T
+        // is decltype((x)).
+        template <typename Expr>
+        using IfPair = std::enable_if_t<std::extent_v<std::remove_reference_t<Expr>> == 2>;
+
+        template <typename Expr, typename = IfPair<Expr>>
+        auto bindByValue() {
+            [[maybe_unused]] auto [x, y] = make<Expr>();
+            return Deduction<decltype(x), decltype((x))>{};
+        }
+
+        template <typename Expr, typename = IfPair<Expr>, typename = decltype(passByRef(std::declval<Expr>()))>
+        auto bindByRef() {
+            [[maybe_unused]] auto& [x, y] = make<Expr>();
+            return Deduction<decltype(x), decltype((x))>{};
+        }
+
+        template <typename Expr, typename = IfPair<Expr>>
+        auto bindByURef() {
+            [[maybe_unused]] auto&& [x, y] = make<Expr>();
+            return Deduction<decltype(x), decltype((x))>{};
+        }
+    }
+
+    // Class templates for CTAD: Box{e} deduces from a by-value constructor,
+    // Ref{e} from T&&, which in a class template's constructor is not a
+    // forwarding reference.
+    template <typename T>
+    struct Box {
+        using type = T;
+        Box(T value);
+    };
+
+    template <typename T>
+    struct Ref {
+        using type = T;
+        Ref(T&& value);
+    };
+
+    namespace probe {
+        template <typename Class>
+        using ClassDeduction = Deduction<Class, typename Class::type>;
+    }
+}
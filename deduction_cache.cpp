@@ -0,0 +1,456 @@
+#include "deduction_cache.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ttd {
+    struct DeductionCache::Header {
+        char magic[8];
+        std::uint32_t version;
+        std::atomic<std::uint32_t> retired;
+        std::uint64_t slotCount;            // a power of two
+        std::uint64_t heapCapacity;
+        std::atomic<std::uint64_t> entryCount;
+        std::atomic<std::uint64_t> heapUsed;
+    };
+
+    // hash is 0 while the slot is free and is written last.
+    struct DeductionCache::Slot {
+        std::atomic<std::uint64_t> hash;
+        std::uint32_t arg;
+        std::uint32_t param;
+        std::uint32_t T;
+        std::uint16_t argLength;
+        std::uint16_t paramLength;
+        std::uint16_t TLength;
+        std::uint8_t category;
+        std::uint8_t form;
+    };
+
+    namespace {
+        constexpr char magic[8] = { 'T', 'T', 'D', 'C', 'A', 'C', 'H', 'E' };
+        constexpr std::uint64_t initialSlotCount = 4096;
+        constexpr std::uint64_t initialHeapCapacity = 256 * 1024;
+        constexpr std::size_t maxSpellingLength = 0xffff;
+        // Heap offsets are 32 bits; no table gets near 2^40 slots.
+        constexpr std::uint64_t maxHeapCapacity = 0xffffffffull;
+        constexpr std::uint64_t maxSlotCount = std::uint64_t(1) << 40;
+
+        static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "slots are shared between processes");
+        static_assert(sizeof(std::atomic<std::uint64_t>) == sizeof(std::uint64_t), "the file layout has plain words");
+
+        [[noreturn]] void fail(const std::string& what, const std::string& path) {
+            throw std::runtime_error(what + " " + path + ": " + std::strerror(errno));
+        }
+
+        // flock() that retries when interrupted and throws when it fails, so
+        // nobody goes on without the lock.
+        void lock(int fd, int operation, const std::string& path) {
+            while (::flock(fd, operation) != 0) {
+                if (errno != EINTR) {
+                    fail("cannot lock", path);
+                }
+            }
+        }
+
+        // Owns a descriptor until released.
+        class FileDescriptor {
+        public:
+            explicit FileDescriptor(int fd) : _fd(fd) { }
+            ~FileDescriptor() {
+                if (_fd >= 0) {
+                    ::close(_fd);
+                }
+            }
+
+            FileDescriptor(const FileDescriptor&) = delete;
+            FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+            int get() const { return _fd; }
+
+            int release() {
+                int const fd = _fd;
+                _fd = -1;
+                return fd;
+            }
+
+        private:
+            int _fd;
+        };
+
+        // Owns a mapping until released.
+        class Mapping {
+        public:
+            Mapping(void* address, std::size_t size) : _address(address), _size(size) { }
+            ~Mapping() {
+                if (_address != nullptr) {
+                    ::munmap(_address, _size);
+                }
+            }
+
+            Mapping(const Mapping&) = delete;
+            Mapping& operator=(const Mapping&) = delete;
+
+            void* release() {
+                void* const address = _address;
+                _address = nullptr;
+                return address;
+            }
+
+        private:
+            void* _address;
+            std::size_t _size;
+        };
+
+        // Removes a file unless it is kept.
+        class TemporaryFile {
+        public:
+            explicit TemporaryFile(std::string path) : _path(std::move(path)) { }
+            ~TemporaryFile() {
+                if (!_kept) {
+                    ::unlink(_path.c_str());
+                }
+            }
+
+            TemporaryFile(const TemporaryFile&) = delete;
+            TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+            const std::string& path() const { return _path; }
+
+            void keep() { _kept = true; }
+
+        private:
+            std::string _path;
+            bool _kept = false;
+        };
+
+        std::uint64_t keyHash(std::string_view arg, ValueCategory category, DeductionForm form) {
+            std::uint64_t hash = 0xcbf29ce484222325ull;
+            auto mix = [&](unsigned char byte) {
+                hash = (hash ^ byte) * 0x100000001b3ull;
+            };
+            for (char c : arg) {
+                mix(static_cast<unsigned char>(c));
+            }
+            mix(static_cast<unsigned char>(category));
+            mix(static_cast<unsigned char>(form));
+            return hash != 0 ? hash : 1;
+        }
+
+        std::size_t fileSize(std::uint64_t slotCount, std::uint64_t heapCapacity, std::size_t headerSize, std::size_t slotSize) {
+            return headerSize + slotCount * slotSize + heapCapacity;
+        }
+    }
+
+    DeductionCache::DeductionCache(const std::string& path, Mode mode) : _path(path), _mode(mode) {
+        open();
+    }
+
+    DeductionCache::~DeductionCache() {
+        close();
+    }
+
+    void DeductionCache::initialize(int fd, std::uint64_t slotCount, std::uint64_t heapCapacity) {
+        std::size_t const size = fileSize(slotCount, heapCapacity, sizeof(Header), sizeof(Slot));
+        // ftruncate zero-fills, so every slot starts out free.
+        if (::ftruncate(fd, 0) != 0 || ::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            throw std::runtime_error(std::string("cannot size deduction cache: ") + std::strerror(errno));
+        }
+        Header header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = formatVersion;
+        header.slotCount = slotCount;
+        header.heapCapacity = heapCapacity;
+        if (::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))) {
+            throw std::runtime_error(std::string("cannot write deduction cache: ") + std::strerror(errno));
+        }
+    }
+
+    void DeductionCache::open() {
+        bool const writable = _mode == Mode::readWrite;
+        _fd = ::open(_path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (_fd < 0) {
+            fail("cannot open", _path);
+        }
+
+        // Shared is enough to read the header; a writer creating the file
+        // holds it exclusively until the header is in place.
+        try {
+            lock(_fd, writable ? LOCK_EX : LOCK_SH, _path);
+            struct stat status;
+            if (::fstat(_fd, &status) != 0) {
+                fail("cannot stat", _path);
+            }
+            if (status.st_size == 0 && writable) {
+                initialize(_fd, initialSlotCount, initialHeapCapacity);
+            } else {
+                Header header;
+                bool const valid = ::pread(_fd, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header))
+                    && std::memcmp(header.magic, magic, sizeof(magic)) == 0
+                    && header.version == formatVersion;
+                if (!valid) {
+                    throw std::runtime_error("not a deduction cache of version " + std::to_string(formatVersion) + ": " + _path);
+                }
+            }
+            map();
+            lock(_fd, LOCK_UN, _path);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    void DeductionCache::map() {
+        struct stat status;
+        if (::fstat(_fd, &status) != 0) {
+            fail("cannot stat", _path);
+        }
+        _mappingSize = static_cast<std::size_t>(status.st_size);
+        int const protection = _mode == Mode::readWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        _mapping = ::mmap(nullptr, _mappingSize, protection, MAP_SHARED, _fd, 0);
+        if (_mapping == MAP_FAILED) {
+            _mapping = nullptr;
+            fail("cannot map", _path);
+        }
+
+        // Every offset and count below is trusted from here on, so a file
+        // that does not add up is rejected before anything indexes it.
+        _header = static_cast<Header*>(_mapping);
+        bool valid = _mappingSize >= sizeof(Header);
+        if (valid) {
+            std::uint64_t const slotCount = _header->slotCount;
+            std::uint64_t const heapCapacity = _header->heapCapacity;
+            valid = slotCount != 0 && (slotCount & (slotCount - 1)) == 0 && slotCount <= maxSlotCount
+                && heapCapacity <= maxHeapCapacity
+                && _mappingSize == fileSize(slotCount, heapCapacity, sizeof(Header), sizeof(Slot))
+                && _header->entryCount.load(std::memory_order_acquire) * 2 <= slotCount
+                && _header->heapUsed.load(std::memory_order_acquire) <= heapCapacity;
+        }
+        if (!valid) {
+            ::munmap(_mapping, _mappingSize);
+            _mapping = nullptr;
+            _header = nullptr;
+            throw std::runtime_error("corrupted deduction cache: " + _path);
+        }
+        _slots = reinterpret_cast<Slot*>(static_cast<char*>(_mapping) + sizeof(Header));
+        _heap = reinterpret_cast<char*>(_slots + _header->slotCount);
+    }
+
+    void DeductionCache::close() {
+        if (_mapping != nullptr) {
+            ::munmap(_mapping, _mappingSize);
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+        }
+        _fd = -1;
+        _mapping = nullptr;
+        _header = nullptr;
+        _slots = nullptr;
+        _heap = nullptr;
+    }
+
+    // Moves to the file that replaced this one, if any.
+    void DeductionCache::refresh() {
+        while (_header->retired.load(std::memory_order_acquire) != 0) {
+            close();
+            open();
+        }
+    }
+
+    void DeductionCache::lockForWriting() {
+        for (;;) {
+            lock(_fd, LOCK_EX, _path);
+            if (_header->retired.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+            lock(_fd, LOCK_UN, _path);
+            refresh();
+        }
+    }
+
+    const DeductionCache::Slot* DeductionCache::lookup(std::uint64_t hash, std::string_view arg,
+                                                       ValueCategory category, DeductionForm form) const {
+        std::uint64_t const mask = _header->slotCount - 1;
+        std::uint64_t i = hash & mask;
+        for (std::uint64_t probes = 0; probes < _header->slotCount; ++probes, i = (i + 1) & mask) {
+            const Slot& slot = _slots[i];
+            std::uint64_t const slotHash = slot.hash.load(std::memory_order_acquire);
+            if (slotHash == 0) {
+                return nullptr;
+            }
+            if (!inHeap(slot.arg, slot.argLength) || !inHeap(slot.param, slot.paramLength) || !inHeap(slot.T, slot.TLength)) {
+                throw std::runtime_error("corrupted deduction cache: " + _path);
+            }
+            if (slotHash == hash
+                && slot.category == static_cast<std::uint8_t>(category)
+                && slot.form == static_cast<std::uint8_t>(form)
+                && std::string_view(_heap + slot.arg, slot.argLength) == arg) {
+                return &slot;
+            }
+        }
+        // Full tables never exist; only a damaged file has no free slot.
+        throw std::runtime_error("corrupted deduction cache: " + _path);
+    }
+
+    bool DeductionCache::inHeap(std::uint32_t offset, std::uint16_t length) const {
+        return std::uint64_t(offset) + length <= _header->heapCapacity;
+    }
+
+    bool DeductionCache::find(std::string_view arg, ValueCategory category, DeductionForm form, CachedDeduction& result) {
+        refresh();
+        const Slot* const slot = lookup(keyHash(arg, category, form), arg, category, form);
+        if (slot == nullptr) {
+            return false;
+        }
+        result.param = std::string_view(_heap + slot->param, slot->paramLength);
+        result.T = std::string_view(_heap + slot->T, slot->TLength);
+        return true;
+    }
+
+    // Writes one entry; the caller holds the lock and has made room.
+    void DeductionCache::append(std::uint64_t hash, std::string_view arg, ValueCategory category, DeductionForm form,
+                                std::string_view param, std::string_view T) {
+        std::uint64_t used = _header->heapUsed.load(std::memory_order_relaxed);
+        auto store = [&](std::string_view s) {
+            std::uint32_t const offset = static_cast<std::uint32_t>(used);
+            std::memcpy(_heap + used, s.data(), s.size());
+            used += s.size();
+            return offset;
+        };
+
+        std::uint64_t const mask = _header->slotCount - 1;
+        std::uint64_t i = hash & mask;
+        while (_slots[i].hash.load(std::memory_order_relaxed) != 0) {
+            i = (i + 1) & mask;
+        }
+        Slot& slot = _slots[i];
+        slot.arg = store(arg);
+        slot.param = store(param);
+        slot.T = store(T);
+        slot.argLength = static_cast<std::uint16_t>(arg.size());
+        slot.paramLength = static_cast<std::uint16_t>(param.size());
+        slot.TLength = static_cast<std::uint16_t>(T.size());
+        slot.category = static_cast<std::uint8_t>(category);
+        slot.form = static_cast<std::uint8_t>(form);
+
+        _header->heapUsed.store(used, std::memory_order_relaxed);
+        _header->entryCount.fetch_add(1, std::memory_order_relaxed);
+        slot.hash.store(hash, std::memory_order_release);
+    }
+
+    // Replaces the file by one with room for another entry of extraBytes. The
+    // caller holds the lock on the old file and gets it on the new one.
+    void DeductionCache::grow(std::size_t extraBytes) {
+        std::uint64_t slotCount = _header->slotCount;
+        std::uint64_t heapCapacity = _header->heapCapacity;
+        std::uint64_t const entries = _header->entryCount.load(std::memory_order_relaxed) + 1;
+        std::uint64_t const heapNeeded = _header->heapUsed.load(std::memory_order_relaxed) + extraBytes;
+        while (entries * 2 > slotCount) {
+            slotCount *= 2;
+        }
+        while (heapNeeded > heapCapacity) {
+            heapCapacity *= 2;
+        }
+        if (heapCapacity > maxHeapCapacity) {
+            throw std::runtime_error("deduction cache is full: " + _path);
+        }
+
+        TemporaryFile temporary(_path + ".grow." + std::to_string(::getpid()));
+        FileDescriptor fd(::open(temporary.path().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644));
+        if (fd.get() < 0) {
+            fail("cannot create", temporary.path());
+        }
+        lock(fd.get(), LOCK_EX, temporary.path());
+        initialize(fd.get(), slotCount, heapCapacity);
+
+        // The old file stays open and mapped until the new one has replaced
+        // it; if anything fails on the way, it is current again and the new
+        // one goes.
+        FileDescriptor oldFd(_fd);
+        Mapping oldMapping(_mapping, _mappingSize);
+        std::size_t const oldMappingSize = _mappingSize;
+        Header* const oldHeader = _header;
+        Slot* const oldSlots = _slots;
+        char* const oldHeap = _heap;
+
+        _fd = fd.release();
+        _mapping = nullptr;
+        try {
+            map();
+            for (std::uint64_t i = 0; i < oldHeader->slotCount; ++i) {
+                const Slot& slot = oldSlots[i];
+                std::uint64_t const hash = slot.hash.load(std::memory_order_relaxed);
+                if (hash != 0) {
+                    append(hash, std::string_view(oldHeap + slot.arg, slot.argLength),
+                           static_cast<ValueCategory>(slot.category), static_cast<DeductionForm>(slot.form),
+                           std::string_view(oldHeap + slot.param, slot.paramLength),
+                           std::string_view(oldHeap + slot.T, slot.TLength));
+                }
+            }
+            if (::rename(temporary.path().c_str(), _path.c_str()) != 0) {
+                fail("cannot replace", _path);
+            }
+        } catch (...) {
+            close();
+            _fd = oldFd.release();
+            _mapping = oldMapping.release();
+            _mappingSize = oldMappingSize;
+            _header = oldHeader;
+            _slots = oldSlots;
+            _heap = oldHeap;
+            throw;
+        }
+        temporary.keep();
+        oldHeader->retired.store(1, std::memory_order_release);
+    }
+
+    void DeductionCache::insert(std::string_view arg, ValueCategory category, DeductionForm form,
+                                std::string_view param, std::string_view T) {
+        if (_mode != Mode::readWrite) {
+            throw std::logic_error("deduction cache is read-only: " + _path);
+        }
+        if (arg.size() > maxSpellingLength || param.size() > maxSpellingLength || T.size() > maxSpellingLength) {
+            throw std::invalid_argument("spelling too long for the deduction cache");
+        }
+
+        lockForWriting();
+        try {
+            std::uint64_t const hash = keyHash(arg, category, form);
+            if (lookup(hash, arg, category, form) == nullptr) {
+                std::size_t const bytes = arg.size() + param.size() + T.size();
+                bool const full = (_header->entryCount.load(std::memory_order_relaxed) + 1) * 2 > _header->slotCount
+                    || _header->heapUsed.load(std::memory_order_relaxed) + bytes > _header->heapCapacity;
+                if (full) {
+                    grow(bytes);
+                }
+                append(hash, arg, category, form, param, T);
+            }
+        } catch (...) {
+            // The error on its way out matters more than a failed unlock,
+            // and closing the file drops the lock anyway.
+            ::flock(_fd, LOCK_UN);
+            throw;
+        }
+        lock(_fd, LOCK_UN, _path);
+    }
+
+    std::size_t DeductionCache::size() {
+        refresh();
+        return static_cast<std::size_t>(_header->entryCount.load(std::memory_order_acquire));
+    }
+
+    std::size_t DeductionCache::capacity() {
+        refresh();
+        return static_cast<std::size_t>(_header->slotCount / 2);
+    }
+}
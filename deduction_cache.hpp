@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "deduction_form.hpp"
+#include "value_category.hpp"
+
+// A persistent cache of deduction results, shared through a memory-mapped file.
+//
+// The file is a versioned header, an open-addressing hash table of fixed-size
+// slots and a heap of spellings. A query hashes (argument spelling, value
+// category, form), probes the mapped slots and returns views of the param and
+// T spellings in the mapping, so a fresh process answers without building any
+// types, let alone demangling.
+//
+// Entries are only ever appended. A writer takes an exclusive flock(), writes
+// the spellings and the slot, and publishes the slot by storing its hash last;
+// readers take no lock and see an entry either completely or not at all. When
+// the table passes half full or the heap runs out, the writer copies every
+// entry into a file twice the size, renames it over the old one and marks the
+// old one retired; everyone who had it open moves to the new file on their
+// next call.
+//
+// Keys are compared byte for byte, so callers should use one spelling per
+// type, e.g. ttd::printType's default style.
+
+namespace ttd {
+    // Views into the mapping, valid until the next call on the cache.
+    struct CachedDeduction {
+        std::string_view param;     // empty when the call does not compile
+        std::string_view T;
+
+        bool viable() const {
+            return !param.empty();
+        }
+    };
+
+    class DeductionCache {
+    public:
+        enum class Mode {
+            readOnly,       // the file must exist
+            readWrite,      // creates the file, or initializes an empty one
+        };
+
+        static constexpr std::uint32_t formatVersion = 1;
+
+        // Throws std::runtime_error if the file cannot be opened or mapped, is
+        // not empty and not a cache of this version, or is damaged; a file
+        // that is not a cache is left as it is.
+        explicit DeductionCache(const std::string& path, Mode mode = Mode::readOnly);
+        ~DeductionCache();
+
+        DeductionCache(const DeductionCache&) = delete;
+        DeductionCache& operator=(const DeductionCache&) = delete;
+
+        bool find(std::string_view arg, ValueCategory category, DeductionForm form, CachedDeduction& result);
+
+        // Appends an entry unless the key is present. param is empty for a
+        // call that does not compile. Needs readWrite.
+        void insert(std::string_view arg, ValueCategory category, DeductionForm form,
+                    std::string_view param, std::string_view T);
+
+        std::size_t size();
+        std::size_t capacity();
+
+    private:
+        struct Header;
+        struct Slot;
+
+        std::string _path;
+        Mode _mode;
+        int _fd = -1;
+        void* _mapping = nullptr;
+        std::size_t _mappingSize = 0;
+        Header* _header = nullptr;
+        Slot* _slots = nullptr;
+        char* _heap = nullptr;
+
+        void open();
+        void close();
+        void refresh();
+        void map();
+        void lockForWriting();
+        static void initialize(int fd, std::uint64_t slotCount, std::uint64_t heapCapacity);
+        void grow(std::size_t extraBytes);
+        bool inHeap(std::uint32_t offset, std::uint16_t length) const;
+        const Slot* lookup(std::uint64_t hash, std::string_view arg, ValueCategory category, DeductionForm form) const;
+        void append(std::uint64_t hash, std::string_view arg, ValueCategory category, DeductionForm form,
+                    std::string_view param, std::string_view T);
+    };
+}
@@ -0,0 +1,100 @@
+// Answers one deduction question from the persistent cache, and computes and
+// records the answer on a miss.
+//
+//   ttd-cache <cache file> <type> <lvalue|xvalue|prvalue> <form>
+//   ttd-cache <cache file> --stats
+//
+// <form> is one of passByValue, passByRef, passByURef, passByPtr, passByCPtr,
+// passByCRef and passByCRRef. The type may be spelled in any style; it is
+// looked up by its canonical spelling.
+
+#include <cstdio>
+#include <exception>
+#include <string>
+#include <string_view>
+
+#include <sys/stat.h>
+
+#include "deduction_cache.hpp"
+#include "deduction_engine.hpp"
+#include "type_parser.hpp"
+#include "type_printer.hpp"
+
+namespace {
+    void printAnswer(const ttd::CachedDeduction& answer) {
+        if (answer.viable()) {
+            std::printf("  + param type: %.*s\n  + T:          %.*s\n",
+                        int(answer.param.size()), answer.param.data(), int(answer.T.size()), answer.T.data());
+        } else {
+            std::printf("  + no viable deduction\n");
+        }
+    }
+
+    int usage(const char* program) {
+        std::fprintf(stderr, "usage: %s <cache file> <type> <lvalue|xvalue|prvalue> <form>\n"
+                             "       %s <cache file> --stats\n", program, program);
+        return 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    using namespace ttd;
+
+    try {
+        if (argc == 3 && std::string_view(argv[2]) == "--stats") {
+            DeductionCache cache(argv[1]);
+            std::printf("entries:  %zu\ncapacity: %zu\n", cache.size(), cache.capacity());
+            return 0;
+        }
+
+        ValueCategory category;
+        DeductionForm form;
+        if (argc != 5 || !parseValueCategory(argv[3], category) || !parseDeductionForm(argv[4], form)) {
+            return usage(argv[0]);
+        }
+
+        TypeTable types;
+        const Type* const arg = parseType(argv[2], types);
+        if (arg == nullptr) {
+            std::fprintf(stderr, "not a type: %s\n", argv[2]);
+            return 1;
+        }
+        auto const spelling = printType(arg);
+        if (spelling.truncated()) {
+            std::fprintf(stderr, "type name too long: %s\n", argv[2]);
+            return 1;
+        }
+
+        // Most questions are hits: look them up read-only, without the
+        // writers' lock, and only reopen for writing on a miss.
+        CachedDeduction answer;
+        struct stat status;
+        if (::stat(argv[1], &status) == 0 && status.st_size > 0) {
+            DeductionCache cache(argv[1]);
+            if (cache.find(spelling.view(), category, form, answer)) {
+                printAnswer(answer);
+                return 0;
+            }
+        }
+
+        DeductionEngine engine(types);
+        DeductionResult const result = engine.compute(arg, category, form);
+        DeductionCache cache(argv[1], DeductionCache::Mode::readWrite);
+        if (result.viable()) {
+            auto const param = printType<1024>(result.param);
+            auto const T = printType<1024>(result.T);
+            if (param.truncated() || T.truncated()) {
+                std::fprintf(stderr, "deduced type name too long: %s\n", argv[2]);
+                return 1;
+            }
+            cache.insert(spelling.view(), category, form, param.view(), T.view());
+        } else {
+            cache.insert(spelling.view(), category, form, std::string_view(), std::string_view());
+        }
+        cache.find(spelling.view(), category, form, answer);
+        printAnswer(answer);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
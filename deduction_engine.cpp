@@ -0,0 +1,114 @@
+#include "deduction_engine.hpp"
+
+#include <functional>
+
+namespace ttd {
+    std::size_t DeductionEngine::KeyHash::operator()(const Key& key) const {
+        std::size_t const tag = static_cast<std::size_t>(key.category) * deductionFormCount + static_cast<std::size_t>(key.form);
+        return std::hash<const Type*>()(key.arg) * 31 + tag;
+    }
+
+    // Array-to-pointer and function-to-pointer conversion.
+    const Type* DeductionEngine::decay(const Type* type) {
+        switch (type->kind) {
+        case TypeKind::array:
+            return _types.pointerTo(type->element);
+        case TypeKind::function:
+            return _types.pointerTo(type);
+        default:
+            return type;
+        }
+    }
+
+    DeductionResult DeductionEngine::deduce(const Type* arg, ValueCategory category, DeductionForm form) {
+        Key const key{ arg, category, form };
+        auto const found = _memo.find(key);
+        if (found != _memo.end()) {
+            return found->second;
+        }
+        DeductionResult const result = compute(arg, category, form);
+        _memo.emplace(key, result);
+        return result;
+    }
+
+    DeductionResult DeductionEngine::compute(const Type* arg, ValueCategory category, DeductionForm form) {
+        if (arg->isReference()) {
+            arg = arg->element;
+        }
+
+        bool const isFunction = arg->kind == TypeKind::function;
+        bool const isLvalue = isFunction || category == ValueCategory::lvalue;
+        DeductionResult const none{ nullptr, nullptr };
+
+        switch (form) {
+        case DeductionForm::passByValue: {
+            // Decay, then drop top-level cv: the parameter is a fresh object.
+            const Type* const T = _types.withoutCv(decay(arg));
+            return { T, T };
+        }
+
+        case DeductionForm::passByRef: {
+            // T keeps cv; an rvalue only binds if that makes the parameter a
+            // reference to const.
+            unsigned char const cv = TypeTable::cvOf(arg);
+            if (!isLvalue && cv != cvConst) {
+                return none;
+            }
+            return { _types.lvalueReferenceTo(arg), arg };
+        }
+
+        case DeductionForm::passByURef: {
+            // Forwarding reference: lvalues deduce T as an lvalue reference.
+            if (isLvalue) {
+                const Type* const T = _types.lvalueReferenceTo(arg);
+                return { T, T };
+            }
+            return { _types.rvalueReferenceTo(arg), arg };
+        }
+
+        case DeductionForm::passByPtr:
+        case DeductionForm::passByCPtr: {
+            const Type* const pointer = decay(arg);
+            if (pointer->kind != TypeKind::pointer) {
+                return none;
+            }
+            const Type* const pointee = pointer->element;
+            if (form == DeductionForm::passByPtr) {
+                return { _types.pointerTo(pointee), pointee };
+            }
+            // There is no `const` on a function type to match against.
+            if (pointee->kind == TypeKind::function) {
+                return none;
+            }
+            const Type* const T = _types.withoutCv(pointee, cvConst);
+            return { _types.pointerTo(_types.withCv(T, cvConst)), T };
+        }
+
+        case DeductionForm::passByCRef: {
+            if (isFunction) {
+                return { _types.lvalueReferenceTo(arg), arg };
+            }
+            // const volatile& does not bind to rvalues.
+            if (!isLvalue && (TypeTable::cvOf(arg) & cvVolatile) != 0) {
+                return none;
+            }
+            const Type* const T = _types.withoutCv(arg, cvConst);
+            return { _types.lvalueReferenceTo(_types.withCv(T, cvConst)), T };
+        }
+
+        case DeductionForm::passByCRRef: {
+            // An rvalue reference to a function binds to function lvalues.
+            if (isFunction) {
+                return { _types.rvalueReferenceTo(arg), arg };
+            }
+            if (isLvalue) {
+                return none;
+            }
+            const Type* const T = _types.withoutCv(arg, cvConst);
+            return { _types.rvalueReferenceTo(_types.withCv(T, cvConst)), T };
+        }
+        }
+
+        return none;
+    }
+}
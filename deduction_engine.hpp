@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "deduction_form.hpp"
+#include "type_model.hpp"
+#include "value_category.hpp"
+
+// Template argument deduction for the seven passBy* forms, on the runtime
+// type model instead of the compiler.
+//
+// An argument is described by the type of the expression and its value
+// category, exactly as the compiler sees it: `ra` declared as `int& ra` is an
+// lvalue of type int, `std::move(a)` an xvalue of type int. A reference type
+// passed as the argument type is taken to be the type of the variable and is
+// stripped. Function expressions are lvalues whatever category is given.
+
+namespace ttd {
+    // param and T are null when the call does not compile.
+    struct DeductionResult {
+        const Type* param;
+        const Type* T;
+
+        bool viable() const {
+            return param != nullptr;
+        }
+    };
+
+    class DeductionEngine {
+    public:
+        explicit DeductionEngine(TypeTable& types) : _types(types) { }
+
+        // Memoized per (argument type, value category, form).
+        DeductionResult deduce(const Type* arg, ValueCategory category, DeductionForm form);
+
+        // The same without the memo, for callers that keep their own.
+        DeductionResult compute(const Type* arg, ValueCategory category, DeductionForm form);
+
+        TypeTable& types() {
+            return _types;
+        }
+
+    private:
+        struct Key {
+            const Type* arg;
+            ValueCategory category;
+            DeductionForm form;
+
+            bool operator==(const Key& other) const {
+                return arg == other.arg && category == other.category && form == other.form;
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        const Type* decay(const Type* type);
+
+        TypeTable& _types;
+        std::unordered_map<Key, DeductionResult, KeyHash> _memo;
+    };
+}
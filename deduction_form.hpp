@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace ttd {
+    enum class DeductionForm : unsigned char {
+        passByValue,        // T
+        passByRef,          // T&
+        passByURef,         // T&&
+        passByPtr,          // T*
+        passByCPtr,         // T const*
+        passByCRef,         // T const&
+        passByCRRef,        // T const&&
+    };
+
+    constexpr std::size_t deductionFormCount = 7;
+
+    // Indexed by DeductionForm; the names of the passBy* templates.
+    constexpr std::string_view deductionFormNames[deductionFormCount] = {
+        "passByValue", "passByRef", "passByURef", "passByPtr", "passByCPtr", "passByCRef", "passByCRRef",
+    };
+
+    // The form named name, if any.
+    constexpr bool parseDeductionForm(std::string_view name, DeductionForm& form) {
+        for (std::size_t i = 0; i < deductionFormCount; ++i) {
+            if (name == deductionFormNames[i]) {
+                form = static_cast<DeductionForm>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,750 @@
+// Differential fuzzing of template argument deduction: the compiler against
+// ttd::DeductionEngine.
+//
+//   deduction-fuzz [--compiler CXX] [--std c++NN] [--flags "..."]
+//                  [--seed N] [--batches N] [--batch-size N] [--depth N]
+//                  [--jobs N] [--work DIR] [--minimize N] [--keep]
+//
+// Each batch is one translation unit holding thousands of random cases. A
+// case is a declarator (cv-qualifiers, pointers, arrays with and without a
+// bound, references and function types, nested up to --depth), a value
+// category and one of the seven passBy* forms. Every declarator is paired
+// with every form and with each category it can have. The TU runs the
+// deduction probes of deduction_probe.hpp on all of them and prints what the
+// compiler deduced. Compiler startup and the boost headers are paid once per
+// batch rather than once per case. Batches are built --jobs at a time.
+//
+// Each answer is compared with the engine's prediction, after both are
+// printed in ttd::printType's default style. A case that the compiler
+// rejects outright does not stop its batch: the batch is halved until the
+// case is alone and counts as a mismatch. Up to --minimize mismatches are
+// then shrunk, again in batches: each round compiles every one-step
+// simplification of every mismatch, such as dropping a qualifier or a
+// parameter, or replacing a type by one of its parts. A mismatch is replaced
+// by its smallest simplification that still mismatches, until none does.
+//
+// The exit status is 1 if there was a mismatch. A run is reproducible from
+// its --seed and --batch-size.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "deduction_engine.hpp"
+#include "scrub_type_name.hpp"
+#include "tool_support.hpp"
+#include "type_parser.hpp"
+#include "type_printer.hpp"
+
+namespace {
+    using ttd::DeductionForm;
+    using ttd::Type;
+    using ttd::TypeKind;
+    using ttd::TypeTable;
+    using ttd::ValueCategory;
+    using ttd::tools::readFile;
+    using ttd::tools::run;
+    using ttd::tools::split;
+
+    // Leaves of the declarators. fuzz::S is a class, defined in every batch.
+    const char* const leafNames[] = { "int", "char", "unsigned int", "long", "double", "bool", "fuzz::S" };
+
+    // Names of the probe structs in a batch, indexed by DeductionForm.
+    const char* const probeNames[ttd::deductionFormCount] = {
+        "PassByValue", "PassByRef", "PassByURef", "PassByPtr", "PassByCPtr", "PassByCRef", "PassByCRRef",
+    };
+
+    constexpr ValueCategory categories[] = { ValueCategory::lvalue, ValueCategory::xvalue, ValueCategory::prvalue };
+
+    struct Options {
+        std::string compiler = "c++";
+        std::string standard = "c++17";
+        std::string flags;
+        std::uint64_t seed = 1;
+        std::size_t batches = 4;
+        std::size_t batchSize = 4096;
+        std::size_t depth = 4;
+        std::size_t jobs = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+        std::size_t minimize = 16;
+        std::string work = "deduction-fuzz";
+        std::vector<std::string> includes;
+        bool keep = false;
+    };
+
+    // Where a type appears; each place allows different types.
+    enum class Slot {
+        declared,       // the declared type of the argument variable
+        pointee,
+        referee,
+        element,        // of an array
+        result,         // of a function
+        parameter,      // of a function, after adjustment
+    };
+
+    struct Case {
+        const Type* declared;
+        ValueCategory category;
+        DeductionForm form;
+    };
+
+    struct Mismatch {
+        Case original;
+        Case minimized;
+        std::string predicted;
+        std::string compiled;
+        std::size_t batch;
+    };
+
+    std::string spell(const Type* type) {
+        std::string spelling(64, '\0');
+        std::size_t size = ttd::printType(type, &spelling[0], spelling.size());
+        if (size > spelling.size()) {
+            spelling.resize(size);
+            size = ttd::printType(type, &spelling[0], spelling.size());
+        }
+        spelling.resize(size);
+        return spelling;
+    }
+
+    bool isVoid(const Type* type) {
+        return type->kind == TypeKind::named && type->name == "void";
+    }
+
+    // Whether type is well-formed in slot, all the way down.
+    bool valid(const Type* type, Slot slot) {
+        bool const topCv = (type->kind == TypeKind::named || type->kind == TypeKind::pointer) && type->cv != ttd::cvNone;
+        if (topCv && (slot == Slot::result || slot == Slot::parameter)) {
+            return false;
+        }
+        switch (type->kind) {
+        case TypeKind::named:
+            return !isVoid(type) || slot == Slot::pointee || slot == Slot::result;
+        case TypeKind::pointer:
+            return valid(type->element, Slot::pointee);
+        case TypeKind::lvalueReference:
+        case TypeKind::rvalueReference:
+            return (slot == Slot::declared || slot == Slot::result || slot == Slot::parameter)
+                && valid(type->element, Slot::referee);
+        case TypeKind::array:
+            if (slot == Slot::result || slot == Slot::parameter || (slot == Slot::element && type->bound == 0)) {
+                return false;
+            }
+            return valid(type->element, Slot::element);
+        case TypeKind::function:
+            if (slot != Slot::declared && slot != Slot::pointee && slot != Slot::referee) {
+                return false;
+            }
+            for (std::size_t i = 0; i < type->paramCount; ++i) {
+                if (!valid(type->params[i], Slot::parameter)) {
+                    return false;
+                }
+            }
+            return valid(type->element, Slot::result);
+        }
+        return false;
+    }
+
+    // Whether the argument can be an expression of category: there are no
+    // array or function prvalues, and a prvalue of a cv-qualified type is
+    // left out because a non-class one would lose its qualifiers.
+    bool hasCategory(const Type* declared, ValueCategory category) {
+        if (category != ValueCategory::prvalue) {
+            return true;
+        }
+        const Type* const object = declared->isReference() ? declared->element : declared;
+        return object->kind != TypeKind::array && object->kind != TypeKind::function && TypeTable::cvOf(object) == ttd::cvNone;
+    }
+
+    // The type that Expr make<Expr>() returns for an argument of category.
+    const Type* expressionType(TypeTable& types, const Case& c) {
+        const Type* const object = c.declared->isReference() ? c.declared->element : c.declared;
+        switch (c.category) {
+        case ValueCategory::lvalue:
+            return types.lvalueReferenceTo(object);
+        case ValueCategory::xvalue:
+            return types.rvalueReferenceTo(object);
+        case ValueCategory::prvalue:
+            break;
+        }
+        return object;
+    }
+
+    class Generator {
+    public:
+        Generator(TypeTable& types, std::uint64_t seed, std::size_t batch) : _types(types) {
+            std::seed_seq sequence{ static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32),
+                                    static_cast<std::uint32_t>(batch) };
+            _random.seed(sequence);
+        }
+
+        const Type* generate(Slot slot, std::size_t depth) {
+            for (;;) {
+                const Type* const type = attempt(slot, depth);
+                if (valid(type, slot)) {
+                    return type;
+                }
+            }
+        }
+
+    private:
+        std::size_t below(std::size_t n) {
+            return std::uniform_int_distribution<std::size_t>(0, n - 1)(_random);
+        }
+
+        unsigned char cv() {
+            // Mostly unqualified, so that qualifiers stand out where they are.
+            std::size_t const roll = below(8);
+            return roll < 4 ? ttd::cvNone : roll < 6 ? ttd::cvConst : roll < 7 ? ttd::cvVolatile : ttd::cvConstVolatile;
+        }
+
+        const Type* leaf(Slot slot) {
+            if ((slot == Slot::pointee || slot == Slot::result) && below(6) == 0) {
+                return _types.named("void", slot == Slot::pointee ? cv() : static_cast<unsigned char>(ttd::cvNone));
+            }
+            return _types.named(leafNames[below(std::size(leafNames))], cv());
+        }
+
+        const Type* attempt(Slot slot, std::size_t depth) {
+            if (depth == 0 || below(depth + 2) == 0) {
+                return leaf(slot);
+            }
+            switch (below(5)) {
+            case 0:
+                return _types.pointerTo(generate(Slot::pointee, depth - 1), cv());
+            case 1: {
+                const Type* const referee = generate(Slot::referee, depth - 1);
+                return below(2) == 0 ? _types.lvalueReferenceTo(referee) : _types.rvalueReferenceTo(referee);
+            }
+            case 2: {
+                std::size_t const bound = slot == Slot::element || below(4) != 0 ? 1 + below(4) : 0;
+                return _types.withCv(_types.arrayOf(generate(Slot::element, depth - 1), bound), below(3) == 0 ? cv() : static_cast<unsigned char>(ttd::cvNone));
+            }
+            case 3: {
+                const Type* params[3];
+                std::size_t const count = below(4);
+                for (std::size_t i = 0; i < count; ++i) {
+                    params[i] = generate(Slot::parameter, depth - 1);
+                }
+                return _types.function(generate(Slot::result, depth - 1), params, count, below(8) == 0);
+            }
+            default:
+                return leaf(slot);
+            }
+        }
+
+        TypeTable& _types;
+        std::mt19937_64 _random;
+    };
+
+    // The types one step simpler than type that are still valid in slot.
+    void simplifications(TypeTable& types, const Type* type, Slot slot, std::vector<const Type*>& out) {
+        std::size_t const first = out.size();
+        auto const inner = [&](const Type* part, Slot partSlot, auto rebuild) {
+            std::vector<const Type*> parts;
+            simplifications(types, part, partSlot, parts);
+            for (const Type* simpler : parts) {
+                out.push_back(rebuild(simpler));
+            }
+        };
+
+        switch (type->kind) {
+        case TypeKind::named:
+            if (type->name != "int" && !isVoid(type)) {
+                out.push_back(types.named("int", type->cv));
+            }
+            break;
+        case TypeKind::pointer:
+            out.push_back(type->element);
+            inner(type->element, Slot::pointee, [&](const Type* simpler) { return types.pointerTo(simpler, type->cv); });
+            break;
+        case TypeKind::lvalueReference:
+        case TypeKind::rvalueReference:
+            out.push_back(type->element);
+            inner(type->element, Slot::referee, [&](const Type* simpler) {
+                return type->kind == TypeKind::lvalueReference ? types.lvalueReferenceTo(simpler) : types.rvalueReferenceTo(simpler);
+            });
+            break;
+        case TypeKind::array:
+            out.push_back(type->element);
+            if (type->bound > 1) {
+                out.push_back(types.arrayOf(type->element, 1));
+            }
+            inner(type->element, Slot::element, [&](const Type* simpler) { return types.arrayOf(simpler, type->bound); });
+            break;
+        case TypeKind::function: {
+            out.push_back(type->element);
+            std::vector<const Type*> params(type->params, type->params + type->paramCount);
+            if (type->variadic) {
+                out.push_back(types.function(type->element, params.data(), params.size(), false));
+            }
+            for (std::size_t i = 0; i < params.size(); ++i) {
+                std::vector<const Type*> fewer = params;
+                fewer.erase(fewer.begin() + static_cast<std::ptrdiff_t>(i));
+                out.push_back(types.function(type->element, fewer.data(), fewer.size(), type->variadic));
+                inner(params[i], Slot::parameter, [&](const Type* simpler) {
+                    std::vector<const Type*> replaced = params;
+                    replaced[i] = simpler;
+                    return types.function(type->element, replaced.data(), replaced.size(), type->variadic);
+                });
+            }
+            inner(type->element, Slot::result, [&](const Type* simpler) {
+                return types.function(simpler, params.data(), params.size(), type->variadic);
+            });
+            break;
+        }
+        }
+
+        // Qualifiers go one at a time, at the top first.
+        unsigned char const cv = TypeTable::cvOf(type);
+        if ((cv & ttd::cvConst) != 0) {
+            out.push_back(types.withoutCv(type, ttd::cvConst));
+        }
+        if ((cv & ttd::cvVolatile) != 0) {
+            out.push_back(types.withoutCv(type, ttd::cvVolatile));
+        }
+
+        out.erase(std::remove_if(out.begin() + static_cast<std::ptrdiff_t>(first), out.end(),
+                                 [&](const Type* simpler) { return simpler == type || !valid(simpler, slot); }),
+                  out.end());
+    }
+
+    // Nodes and qualifiers, so that every simplification is smaller.
+    std::size_t complexity(const Type* type) {
+        std::size_t size = 1 + (type->cv & ttd::cvConst ? 1 : 0) + (type->cv & ttd::cvVolatile ? 1 : 0) + type->variadic;
+        if (type->kind == TypeKind::named) {
+            return size + (type->name != "int");
+        }
+        for (std::size_t i = 0; i < type->paramCount; ++i) {
+            size += complexity(type->params[i]);
+        }
+        return size + complexity(type->element) + (type->bound > 1);
+    }
+
+    std::string predict(ttd::DeductionEngine& engine, const Case& c) {
+        ttd::DeductionResult const result = engine.compute(c.declared, c.category, c.form);
+        if (!result.viable()) {
+            return "no viable deduction";
+        }
+        return spell(result.param) + " / " + spell(result.T);
+    }
+
+    // One spelling per type; a name the parser does not take is only scrubbed.
+    std::string normalize(std::string name, TypeTable& types) {
+        if (const Type* const type = ttd::parseType(name, types)) {
+            return spell(type);
+        }
+        name.resize(ttd::scrubTypeName(&name[0], name.size()));
+        return name;
+    }
+
+    std::string batchSource(TypeTable& types, const std::vector<Case>& cases) {
+        std::string source =
+            "#include <cstdio>\n"
+            "#include <string>\n"
+            "\n"
+            "#include <boost/type_index.hpp>\n"
+            "\n"
+            "#include \"deduction_probe.hpp\"\n"
+            "\n"
+            "namespace fuzz {\n"
+            "    struct S { };\n"
+            "}\n"
+            "\n"
+            "namespace {\n"
+            "    struct NotDeducible { };\n"
+            "\n"
+            "    // An expression of type Expr: Expr& is an lvalue, Expr&& an xvalue\n"
+            "    // and any other Expr a prvalue.\n"
+            "    template <typename Expr>\n"
+            "    Expr make();\n"
+            "\n"
+            "#define TTD_FUZZ_FORM(Form, function)                                          \\\n"
+            "    struct Form {                                                               \\\n"
+            "        template <typename Expr>                                                \\\n"
+            "        static decltype(ttd::probe::function(make<Expr>())) deduce(int);        \\\n"
+            "        template <typename Expr>                                                \\\n"
+            "        static NotDeducible deduce(...);                                        \\\n"
+            "    };\n"
+            "\n";
+        for (std::size_t i = 0; i < ttd::deductionFormCount; ++i) {
+            source += "    TTD_FUZZ_FORM(" + std::string(probeNames[i]) + ", " + std::string(ttd::deductionFormNames[i]) + ")\n";
+        }
+        source +=
+            "\n"
+            "    template <typename T>\n"
+            "    std::string nameOf() {\n"
+            "        return boost::typeindex::type_id_with_cvr<T>().pretty_name();\n"
+            "    }\n"
+            "\n"
+            "    void print(unsigned id, NotDeducible*) {\n"
+            "        std::printf(\"%u\\t!\\t!\\n\", id);\n"
+            "    }\n"
+            "\n"
+            "    template <typename Param, typename T>\n"
+            "    void print(unsigned id, ttd::Deduction<Param, T>*) {\n"
+            "        std::printf(\"%u\\t%s\\t%s\\n\", id, nameOf<Param>().c_str(), nameOf<T>().c_str());\n"
+            "    }\n"
+            "\n"
+            "    template <typename Form, typename Expr>\n"
+            "    void c(unsigned id) {\n"
+            "        print(id, static_cast<decltype(Form::template deduce<Expr>(0))*>(nullptr));\n"
+            "    }\n"
+            "}\n"
+            "\n"
+            "int main() {\n";
+        for (std::size_t i = 0; i < cases.size(); ++i) {
+            source += "    c<" + std::string(probeNames[static_cast<std::size_t>(cases[i].form)]) + ", "
+                    + spell(expressionType(types, cases[i])) + ">(" + std::to_string(i) + ");\n";
+        }
+        source += "}\n";
+        return source;
+    }
+
+    class Runner {
+    public:
+        Runner(const Options& options, std::string name) : _options(options), _path(options.work + "/" + std::move(name)) { }
+
+        // The compiler's answer for every case, in the form predict() gives;
+        // "does not compile" for a case that breaks the build on its own.
+        std::vector<std::string> evaluate(TypeTable& types, const std::vector<Case>& cases) {
+            std::vector<std::string> answers(cases.size());
+            evaluate(types, cases, 0, cases.size(), answers);
+            if (!_options.keep) {
+                ::unlink((_path + ".cpp").c_str());
+                ::unlink(_path.c_str());
+                ::unlink((_path + ".txt").c_str());
+            }
+            return answers;
+        }
+
+        // Whether a batch without cases builds; if not, halving a batch that
+        // fails would only build it case by case.
+        bool buildsEmpty(TypeTable& types) {
+            return build(types, {});
+        }
+
+        std::string log() const {
+            return _path + ".txt";
+        }
+
+        double compileSeconds() const {
+            return _compileSeconds;
+        }
+
+        std::size_t compiles() const {
+            return _compiles;
+        }
+
+    private:
+        std::vector<std::string> compileCommand() const {
+            std::vector<std::string> argv = { _options.compiler, "-std=" + _options.standard, "-O0", "-w", "-I", TTD_SOURCE_DIR };
+            for (const std::string& dir : _options.includes) {
+                argv.push_back("-I");
+                argv.push_back(dir);
+            }
+            for (const std::string& flag : split(_options.flags, ' ')) {
+                argv.push_back(flag);
+            }
+            argv.push_back(_path + ".cpp");
+            argv.push_back("-o");
+            argv.push_back(_path);
+            return argv;
+        }
+
+        bool build(TypeTable& types, const std::vector<Case>& cases) {
+            std::ofstream(_path + ".cpp", std::ios::binary) << batchSource(types, cases);
+            auto const start = std::chrono::steady_clock::now();
+            bool const built = run(compileCommand(), _path + ".txt");
+            _compileSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ++_compiles;
+            return built;
+        }
+
+        // A range that does not build is halved until the culprits are alone.
+        void evaluate(TypeTable& types, const std::vector<Case>& all, std::size_t begin, std::size_t end, std::vector<std::string>& answers) {
+            std::vector<Case> const cases(all.begin() + static_cast<std::ptrdiff_t>(begin), all.begin() + static_cast<std::ptrdiff_t>(end));
+            if (!build(types, cases)) {
+                if (cases.size() == 1) {
+                    answers[begin] = "does not compile";
+                    return;
+                }
+                std::size_t const middle = begin + cases.size() / 2;
+                evaluate(types, all, begin, middle, answers);
+                evaluate(types, all, middle, end, answers);
+                return;
+            }
+
+            for (std::size_t i = begin; i < end; ++i) {
+                answers[i] = "no output";
+            }
+            run({ _path }, _path + ".txt");
+            for (const std::string& line : split(readFile(_path + ".txt"), '\n')) {
+                std::vector<std::string> const fields = split(line, '\t');
+                std::size_t const id = fields.size() == 3 ? std::strtoul(fields[0].c_str(), nullptr, 10) : cases.size();
+                if (id >= cases.size()) {
+                    continue;
+                }
+                answers[begin + id] = fields[1] == "!" ? "no viable deduction"
+                                                       : normalize(fields[1], types) + " / " + normalize(fields[2], types);
+            }
+        }
+
+        const Options& _options;
+        std::string _path;
+        double _compileSeconds = 0;
+        std::size_t _compiles = 0;
+    };
+
+    // Every form and category of each new declarator, until the batch is full.
+    std::vector<Case> generateBatch(const Options& options, TypeTable& types, std::size_t batch) {
+        Generator generator(types, options.seed, batch);
+        std::unordered_set<const Type*> seen;
+        std::vector<Case> cases;
+        while (cases.size() < options.batchSize) {
+            const Type* const declared = generator.generate(Slot::declared, options.depth);
+            if (!seen.insert(declared).second) {
+                continue;
+            }
+            for (ValueCategory category : categories) {
+                if (!hasCategory(declared, category)) {
+                    continue;
+                }
+                for (std::size_t form = 0; form < ttd::deductionFormCount; ++form) {
+                    cases.push_back({ declared, category, static_cast<DeductionForm>(form) });
+                }
+            }
+        }
+        return cases;
+    }
+
+    std::string describe(const Case& c) {
+        return std::string(ttd::deductionFormNames[static_cast<std::size_t>(c.form)]) + "  "
+             + std::string(ttd::valueCategoryName(c.category)) + "  " + spell(c.declared);
+    }
+
+    // Shrinks every mismatch one step per round; a round is one batch.
+    void minimize(const Options& options, TypeTable& types, std::vector<Mismatch>& mismatches) {
+        ttd::DeductionEngine engine(types);
+        Runner runner(options, "minimize");
+        std::vector<bool> done(mismatches.size(), false);
+        for (std::size_t round = 1;; ++round) {
+            std::vector<Case> candidates;
+            std::vector<std::size_t> owners;
+            for (std::size_t i = 0; i < mismatches.size(); ++i) {
+                if (done[i]) {
+                    continue;
+                }
+                const Case& current = mismatches[i].minimized;
+                std::vector<const Type*> simpler;
+                simplifications(types, current.declared, Slot::declared, simpler);
+                for (const Type* declared : simpler) {
+                    if (hasCategory(declared, current.category)) {
+                        candidates.push_back({ declared, current.category, current.form });
+                        owners.push_back(i);
+                    }
+                }
+                done[i] = owners.empty() || owners.back() != i;
+            }
+            if (candidates.empty()) {
+                return;
+            }
+
+            std::vector<std::string> const answers = runner.evaluate(types, candidates);
+            std::vector<std::size_t> best(mismatches.size(), candidates.size());
+            for (std::size_t j = 0; j < candidates.size(); ++j) {
+                std::size_t const owner = owners[j];
+                std::string const predicted = predict(engine, candidates[j]);
+                if (answers[j] == predicted) {
+                    continue;
+                }
+                if (best[owner] == candidates.size() || complexity(candidates[j].declared) < complexity(candidates[best[owner]].declared)) {
+                    best[owner] = j;
+                }
+            }
+            std::size_t shrunk = 0;
+            for (std::size_t i = 0; i < mismatches.size(); ++i) {
+                if (done[i]) {
+                    continue;
+                }
+                if (best[i] == candidates.size()) {
+                    done[i] = true;
+                    continue;
+                }
+                Mismatch& mismatch = mismatches[i];
+                mismatch.minimized = candidates[best[i]];
+                mismatch.predicted = predict(engine, mismatch.minimized);
+                mismatch.compiled = answers[best[i]];
+                ++shrunk;
+            }
+            std::fprintf(stderr, "minimize round %zu: %zu candidates, %zu shrunk\n", round, candidates.size(), shrunk);
+        }
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view const arg = argv[i];
+            bool const hasValue = i + 1 < argc;
+            if (arg == "--compiler" && hasValue) {
+                options.compiler = argv[++i];
+            } else if (arg == "--std" && hasValue) {
+                options.standard = argv[++i];
+            } else if (arg == "--flags" && hasValue) {
+                options.flags = argv[++i];
+            } else if (arg == "--seed" && hasValue) {
+                options.seed = std::strtoull(argv[++i], nullptr, 10);
+            } else if (arg == "--batches" && hasValue) {
+                options.batches = std::strtoul(argv[++i], nullptr, 10);
+            } else if (arg == "--batch-size" && hasValue) {
+                options.batchSize = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--depth" && hasValue) {
+                options.depth = std::strtoul(argv[++i], nullptr, 10);
+            } else if (arg == "--jobs" && hasValue) {
+                options.jobs = std::max<std::size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg == "--work" && hasValue) {
+                options.work = argv[++i];
+            } else if (arg == "--minimize" && hasValue) {
+                options.minimize = std::strtoul(argv[++i], nullptr, 10);
+            } else if (arg == "--keep") {
+                options.keep = true;
+            } else {
+                return false;
+            }
+        }
+        options.includes = split(TTD_BOOST_INCLUDE_DIRS, ';');
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr,
+                     "usage: %s [--compiler CXX] [--std c++NN] [--flags \"...\"] [--seed N] [--batches N] [--batch-size N]\n"
+                     "       [--depth N] [--jobs N] [--work DIR] [--minimize N] [--keep]\n",
+                     argv[0]);
+        return 1;
+    }
+    ::mkdir(options.work.c_str(), 0755);
+    {
+        TypeTable types;
+        Runner runner(options, "empty");
+        if (!runner.buildsEmpty(types)) {
+            std::fprintf(stderr, "%s cannot build an empty batch, see %s\n", options.compiler.c_str(), runner.log().c_str());
+            return 1;
+        }
+    }
+
+    // Each thread takes the next batch, with a type table of its own; the
+    // mismatches are kept as spellings and parsed back for minimizing.
+    struct Found {
+        std::size_t batch;
+        Case c;
+        std::string declared;
+        std::string predicted;
+        std::string compiled;
+    };
+    std::vector<Found> found;
+    std::mutex mutex;
+    std::atomic<std::size_t> next{ 0 };
+    std::atomic<std::size_t> totalCases{ 0 };
+    std::atomic<std::size_t> totalCompiles{ 0 };
+    double compileSeconds = 0;
+    auto const start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < std::min(options.jobs, options.batches); ++t) {
+        threads.emplace_back([&] {
+            for (std::size_t batch; (batch = next.fetch_add(1)) < options.batches;) {
+                TypeTable types;
+                ttd::DeductionEngine engine(types);
+                std::vector<Case> const cases = generateBatch(options, types, batch);
+                Runner runner(options, "batch-" + std::to_string(batch));
+                std::vector<std::string> const answers = runner.evaluate(types, cases);
+
+                std::size_t mismatches = 0;
+                std::lock_guard<std::mutex> lock(mutex);
+                for (std::size_t i = 0; i < cases.size(); ++i) {
+                    std::string predicted = predict(engine, cases[i]);
+                    if (answers[i] != predicted) {
+                        found.push_back({ batch, cases[i], spell(cases[i].declared), std::move(predicted), answers[i] });
+                        ++mismatches;
+                    }
+                }
+                totalCases += cases.size();
+                totalCompiles += runner.compiles();
+                compileSeconds += runner.compileSeconds();
+                std::fprintf(stderr, "batch %zu: %zu cases, %zu compiles in %.1f s, %zu mismatches\n", batch, cases.size(),
+                             runner.compiles(), runner.compileSeconds(), mismatches);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double const seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::sort(found.begin(), found.end(), [](const Found& lhs, const Found& rhs) { return lhs.batch < rhs.batch; });
+
+    // One bug tends to show up many times; the first mismatch of each kind
+    // is minimized before any second one is.
+    auto const kind = [](const Found& f) {
+        return std::string(ttd::deductionFormNames[static_cast<std::size_t>(f.c.form)]) + " "
+             + std::string(ttd::valueCategoryName(f.c.category)) + " " + (f.predicted == "no viable deduction" ? "-" : "+")
+             + (f.compiled == "no viable deduction" ? "-" : f.compiled == "does not compile" ? "!" : "+");
+    };
+    std::vector<const Found*> chosen;
+    std::unordered_set<std::string> kinds;
+    for (const Found& f : found) {
+        if (chosen.size() < options.minimize && kinds.insert(kind(f)).second) {
+            chosen.push_back(&f);
+        }
+    }
+    for (const Found& f : found) {
+        if (chosen.size() < options.minimize && std::find(chosen.begin(), chosen.end(), &f) == chosen.end()) {
+            chosen.push_back(&f);
+        }
+    }
+
+    TypeTable types;
+    std::vector<Mismatch> mismatches;
+    for (const Found* f : chosen) {
+        Case c = f->c;
+        c.declared = ttd::parseType(f->declared, types);
+        if (c.declared != nullptr) {
+            mismatches.push_back({ c, c, f->predicted, f->compiled, f->batch });
+        }
+    }
+    minimize(options, types, mismatches);
+
+    // Mismatches that shrink to the same case are one finding.
+    std::unordered_set<std::string> reported;
+    for (const Mismatch& mismatch : mismatches) {
+        std::string const minimized = describe(mismatch.minimized);
+        if (!reported.insert(minimized).second) {
+            continue;
+        }
+        std::printf("mismatch (batch %zu)\n  case:      %s\n  minimized: %s\n  predicted: %s\n  compiler:  %s\n\n", mismatch.batch,
+                    describe(mismatch.original).c_str(), minimized.c_str(), mismatch.predicted.c_str(), mismatch.compiled.c_str());
+    }
+
+    std::printf("%zu cases in %zu batches, %zu compiles, %.1f s (%.1f s compiling, %.0f cases/s overall)\n"
+                "%zu mismatches, %zu minimized to %zu distinct cases\n",
+                totalCases.load(), options.batches, totalCompiles.load(), seconds, compileSeconds,
+                seconds > 0 ? double(totalCases.load()) / seconds : 0.0, found.size(), mismatches.size(),
+                reported.size());
+    return found.empty() ? 0 : 1;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Type-level twins of the passBy* forms: the ttd::DeductionProbe objects
+// `passByValue`, `passByRef`, ... in ttd.hpp.
+//
+// They are only declared, never defined: `decltype(ttd::probe::passByRef(x))`
+// runs the exact same template argument deduction as `passByRef(x)` and names
+// the result as ttd::Deduction<param type, T> without evaluating anything.
+// report_cases.hpp checks them against the templates written out with bodies.
+
+namespace ttd {
+    template <typename Param, typename T>
+    struct Deduction {
+        using param = Param;
+        using type = T;
+    };
+
+    namespace probe {
+        template <typename T>
+        Deduction<T, T> passByValue(T t);
+
+        template <typename T>
+        Deduction<T&, T> passByRef(T& t);
+
+        template <typename T>
+        Deduction<T&&, T> passByURef(T&& t);
+
+        template <typename T>
+        Deduction<T*, T> passByPtr(T* t);
+
+        template <typename T>
+        Deduction<T const*, T> passByCPtr(T const* t);
+
+        template <typename T>
+        Deduction<T const&, T> passByCRef(T const& t);
+
+        template <typename T>
+        Deduction<T const&&, T> passByCRRef(T const&& t);
+    }
+}
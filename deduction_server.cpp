@@ -0,0 +1,471 @@
+#include "deduction_server.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "deduction_engine.hpp"
+#include "type_parser.hpp"
+#include "type_printer.hpp"
+
+namespace ttd {
+    namespace {
+        constexpr std::size_t readChunk = 64 * 1024;
+        // Stop reading from a client that does not read its answers.
+        constexpr std::size_t maxPendingOutput = 4 * 1024 * 1024;
+        // A line this long without a newline is not a query.
+        constexpr std::size_t maxLineLength = 64 * 1024;
+        constexpr int maxEvents = 256;
+        // A worker starts over with empty types and memo past this many
+        // types, so clients sending ever new spellings cannot grow it for good.
+        constexpr std::size_t maxTypes = std::size_t(1) << 18;
+        // How long the listener rests when the process is out of descriptors.
+        constexpr int acceptBackoffMs = 100;
+
+        [[noreturn]] void fail(const std::string& what) {
+            throw std::runtime_error(what + ": " + std::strerror(errno));
+        }
+
+        std::string_view nextWord(std::string_view& line) {
+            std::size_t const start = line.find_first_not_of(' ');
+            if (start == std::string_view::npos) {
+                line = std::string_view();
+                return line;
+            }
+            std::size_t const end = line.find(' ', start);
+            std::string_view const word = line.substr(start, end - start);
+            line = end == std::string_view::npos ? std::string_view() : line.substr(end + 1);
+            return word;
+        }
+
+        void appendType(const Type* type, std::string& out) {
+            char buffer[512];
+            std::size_t const size = printType(type, buffer, sizeof(buffer));
+            if (size <= sizeof(buffer)) {
+                out.append(buffer, size);
+            } else {
+                std::size_t const offset = out.size();
+                out.resize(offset + size);
+                printType(type, &out[offset], size);
+            }
+        }
+
+        // Per-worker deduction state: types and memo persist across queries,
+        // up to maxTypes types.
+        class QueryAnswerer {
+        public:
+            QueryAnswerer() : _state(std::make_unique<State>()) { }
+
+            void answer(std::string_view line, std::string& out) {
+                // Answers are already text, so nothing refers to the old types.
+                if (_state->types.size() > maxTypes) {
+                    _state = std::make_unique<State>();
+                }
+                TypeTable& types = _state->types;
+
+                if (!line.empty() && line.back() == '\r') {
+                    line.remove_suffix(1);
+                }
+                ValueCategory category;
+                DeductionForm form;
+                const Type* arg = nullptr;
+                if (parseValueCategory(nextWord(line), category) && parseDeductionForm(nextWord(line), form)) {
+                    arg = parseType(line, types);
+                }
+                if (arg == nullptr) {
+                    out += "?\n";
+                    return;
+                }
+
+                DeductionResult const result = _state->engine.deduce(arg, category, form);
+                if (!result.viable()) {
+                    out += "!\n";
+                    return;
+                }
+                appendType(result.param, out);
+                out += '\t';
+                appendType(result.T, out);
+                out += '\n';
+            }
+
+        private:
+            struct State {
+                TypeTable types;
+                DeductionEngine engine{ types };
+            };
+
+            std::unique_ptr<State> _state;
+        };
+
+        struct Connection {
+            std::string input;
+            std::string output;
+            std::size_t written = 0;
+            std::uint32_t interest = EPOLLIN;
+            bool closing = false;
+        };
+
+        void setNonBlocking(int fd) {
+            int const flags = ::fcntl(fd, F_GETFL, 0);
+            if (flags < 0 || ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+                fail("cannot make socket non-blocking");
+            }
+        }
+    }
+
+    // One epoll loop over the connections handed to it.
+    class DeductionServer::Worker {
+    public:
+        Worker() {
+            _epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+            _wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (_epollFd < 0 || _wakeFd < 0) {
+                fail("cannot create worker");
+            }
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = _wakeFd;
+            ::epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event);
+        }
+
+        ~Worker() {
+            for (auto& entry : _connections) {
+                ::close(entry.first);
+            }
+            ::close(_wakeFd);
+            ::close(_epollFd);
+        }
+
+        // Called from the accepting thread.
+        void adopt(int fd) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _incoming.push_back(fd);
+            }
+            wake();
+        }
+
+        // Safe to call from a signal handler.
+        void stop() {
+            _stopping = true;
+            wake();
+        }
+
+        void run() {
+            epoll_event events[maxEvents];
+            while (!_stopping) {
+                int const count = ::epoll_wait(_epollFd, events, maxEvents, -1);
+                if (count < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    fail("epoll_wait");
+                }
+                for (int i = 0; i < count; ++i) {
+                    if (events[i].data.fd == _wakeFd) {
+                        drainWakeups();
+                    } else {
+                        serve(events[i].data.fd, events[i].events);
+                    }
+                }
+            }
+        }
+
+    private:
+        int _epollFd = -1;
+        int _wakeFd = -1;
+        std::atomic<bool> _stopping{ false };
+        std::mutex _mutex;
+        std::vector<int> _incoming;
+        std::unordered_map<int, Connection> _connections;
+        QueryAnswerer _answerer;
+
+        void wake() {
+            std::uint64_t const one = 1;
+            ssize_t const ignored = ::write(_wakeFd, &one, sizeof(one));
+            (void)ignored;
+        }
+
+        void drainWakeups() {
+            std::uint64_t value;
+            while (::read(_wakeFd, &value, sizeof(value)) > 0) {
+            }
+
+            std::vector<int> incoming;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                incoming.swap(_incoming);
+            }
+            for (int fd : incoming) {
+                _connections.emplace(fd, Connection());
+                watch(fd, EPOLLIN, EPOLL_CTL_ADD);
+            }
+        }
+
+        void watch(int fd, std::uint32_t events, int operation) {
+            epoll_event event{};
+            // A hang-up only matters while reading; it would fire on every
+            // wait while a slow client drains its answers.
+            event.events = (events & EPOLLIN) ? events | EPOLLRDHUP : events;
+            event.data.fd = fd;
+            ::epoll_ctl(_epollFd, operation, fd, &event);
+        }
+
+        void drop(int fd) {
+            ::epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            _connections.erase(fd);
+        }
+
+        void serve(int fd, std::uint32_t events) {
+            auto const found = _connections.find(fd);
+            if (found == _connections.end()) {
+                return;
+            }
+            Connection& connection = found->second;
+
+            if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                receive(fd, connection);
+            }
+            if (!send(fd, connection)) {
+                drop(fd);
+                return;
+            }
+            if (connection.closing && connection.written == connection.output.size()) {
+                drop(fd);
+                return;
+            }
+
+            // Read while the client keeps up with its answers, write while
+            // there is something to write.
+            bool const pending = connection.written < connection.output.size();
+            bool const reading = !connection.closing && connection.output.size() - connection.written < maxPendingOutput;
+            std::uint32_t const interest = (reading ? EPOLLIN : 0u) | (pending ? EPOLLOUT : 0u);
+            if (interest != connection.interest) {
+                connection.interest = interest;
+                watch(fd, interest, EPOLL_CTL_MOD);
+            }
+        }
+
+        void receive(int fd, Connection& connection) {
+            char buffer[readChunk];
+            for (;;) {
+                ssize_t const received = ::recv(fd, buffer, sizeof(buffer), 0);
+                if (received > 0) {
+                    connection.input.append(buffer, static_cast<std::size_t>(received));
+                    if (static_cast<std::size_t>(received) < sizeof(buffer)) {
+                        break;
+                    }
+                    continue;
+                }
+                if (received < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    connection.closing = true;
+                }
+                break;
+            }
+
+            // Answer every complete line; a batch of queries becomes a batch
+            // of answers and leaves in one send.
+            std::string_view input = connection.input;
+            std::size_t consumed = 0;
+            for (;;) {
+                std::size_t const newline = input.find('\n', consumed);
+                if (newline == std::string_view::npos) {
+                    break;
+                }
+                _answerer.answer(input.substr(consumed, newline - consumed), connection.output);
+                consumed = newline + 1;
+            }
+            connection.input.erase(0, consumed);
+            if (connection.input.size() > maxLineLength) {
+                connection.output += "?\n";
+                connection.closing = true;
+            }
+        }
+
+        // Returns false if the connection is broken.
+        bool send(int fd, Connection& connection) {
+            while (connection.written < connection.output.size()) {
+                ssize_t const sent = ::send(fd, connection.output.data() + connection.written,
+                                            connection.output.size() - connection.written, MSG_NOSIGNAL);
+                if (sent < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return errno == EAGAIN || errno == EWOULDBLOCK;
+                }
+                connection.written += static_cast<std::size_t>(sent);
+            }
+            connection.output.clear();
+            connection.written = 0;
+            return true;
+        }
+    };
+
+    DeductionServer::DeductionServer(const std::string& path, std::size_t workerCount) : _path(path) {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("socket path too long: " + path);
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        _listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        _stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_listenFd < 0 || _stopFd < 0) {
+            fail("cannot create socket");
+        }
+        // Replace a socket left by an earlier server, but nothing else.
+        struct stat status;
+        if (::lstat(path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                ::close(_listenFd);
+                ::close(_stopFd);
+                throw std::runtime_error("not a socket, not replacing it: " + path);
+            }
+            ::unlink(path.c_str());
+        }
+        if (::bind(_listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+            fail("cannot bind " + path);
+        }
+        if (::listen(_listenFd, SOMAXCONN) < 0) {
+            fail("cannot listen on " + path);
+        }
+        setNonBlocking(_listenFd);
+
+        for (std::size_t i = 0; i < (workerCount > 0 ? workerCount : 1); ++i) {
+            _workers.push_back(std::make_unique<Worker>());
+        }
+    }
+
+    DeductionServer::~DeductionServer() {
+        stop();
+        for (std::thread& thread : _threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+        ::close(_listenFd);
+        ::close(_stopFd);
+        ::unlink(_path.c_str());
+    }
+
+    void DeductionServer::stop() {
+        for (const std::unique_ptr<Worker>& worker : _workers) {
+            worker->stop();
+        }
+        std::uint64_t const one = 1;
+        ssize_t const ignored = ::write(_stopFd, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    void DeductionServer::run() {
+        // A worker that fails takes the server down with it rather than the
+        // process; its error is rethrown below.
+        for (const std::unique_ptr<Worker>& worker : _workers) {
+            _threads.emplace_back([this, worker = worker.get()] {
+                try {
+                    worker->run();
+                } catch (...) {
+                    {
+                        std::lock_guard<std::mutex> lock(_failureMutex);
+                        if (!_failure) {
+                            _failure = std::current_exception();
+                        }
+                    }
+                    stop();
+                }
+            });
+        }
+
+        int const epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            fail("epoll_create1");
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = _listenFd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, _listenFd, &event);
+        event.data.fd = _stopFd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, _stopFd, &event);
+
+        std::size_t next = 0;
+        bool running = true;
+        bool listening = true;
+        auto const watchListener = [&](bool on) {
+            event.events = on ? std::uint32_t(EPOLLIN) : 0u;
+            event.data.fd = _listenFd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_MOD, _listenFd, &event);
+            listening = on;
+        };
+        int waitError = 0;
+        while (running) {
+            epoll_event ready[2];
+            int const count = ::epoll_wait(epollFd, ready, 2, listening ? -1 : acceptBackoffMs);
+            if (count < 0 && errno != EINTR) {
+                waitError = errno;
+                break;
+            }
+            if (count == 0 && !listening) {
+                watchListener(true);
+            }
+            for (int i = 0; i < count; ++i) {
+                if (ready[i].data.fd == _stopFd) {
+                    running = false;
+                    continue;
+                }
+                for (;;) {
+                    int const fd = ::accept4(_listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd >= 0) {
+                        _workers[next]->adopt(fd);
+                        next = (next + 1) % _workers.size();
+                        continue;
+                    }
+                    if (errno == EINTR || errno == ECONNABORTED) {
+                        continue;
+                    }
+                    // Out of descriptors or memory, the connection stays
+                    // queued and the level-triggered listener would wake
+                    // this loop again at once. Rest it until some close.
+                    if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                        watchListener(false);
+                    }
+                    break;
+                }
+            }
+        }
+        ::close(epollFd);
+
+        // The workers only leave their loops when told to, whichever way
+        // this one ended.
+        stop();
+        for (std::thread& thread : _threads) {
+            thread.join();
+        }
+        _threads.clear();
+
+        if (waitError != 0) {
+            errno = waitError;
+            fail("epoll_wait");
+        }
+        if (_failure) {
+            std::rethrow_exception(_failure);
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A long-running deduction service on a Unix-domain socket.
+//
+// The protocol is line based and pipelined: a client may write any number of
+// queries without waiting, and gets one answer line per query, in order.
+//
+//   query:   <lvalue|xvalue|prvalue> <form> <type>\n
+//   answer:  <param type>\t<T>\n      the call deduces
+//            !\n                      no viable deduction
+//            ?\n                      malformed query
+//
+// <form> is one of passByValue, passByRef, passByURef, passByPtr, passByCPtr,
+// passByCRef and passByCRRef, and answers use ttd::printType's default style.
+//
+// The accepting thread hands each connection to one of a few workers. Every
+// worker runs its own epoll loop over its connections with its own TypeTable
+// and DeductionEngine, so a query never crosses threads or takes a lock. A
+// worker drops both and starts afresh once its table holds too many types.
+// When accept() runs out of descriptors, the listener rests for a moment
+// instead of waking the accepting thread in a loop.
+
+namespace ttd {
+    class DeductionServer {
+    public:
+        // Binds and listens on path, replacing a stale socket file but no
+        // other kind of file. Throws std::runtime_error on failure.
+        DeductionServer(const std::string& path, std::size_t workerCount);
+        ~DeductionServer();
+
+        DeductionServer(const DeductionServer&) = delete;
+        DeductionServer& operator=(const DeductionServer&) = delete;
+
+        // Accepts connections until stop(); returns once all workers are done.
+        // If the accepting loop or a worker fails, stops the others and
+        // rethrows that error once they are done.
+        void run();
+
+        // Safe to call from a signal handler.
+        void stop();
+
+    private:
+        class Worker;
+
+        std::string _path;
+        int _listenFd = -1;
+        int _stopFd = -1;
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::thread> _threads;
+        std::mutex _failureMutex;
+        std::exception_ptr _failure;
+    };
+}
@@ -0,0 +1,80 @@
+// Serves deduction queries on a Unix-domain socket until SIGINT or SIGTERM.
+//
+//   ttd-server <socket path> [--workers N]
+//
+// See deduction_server.hpp for the protocol.
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <string_view>
+#include <thread>
+
+#include "deduction_server.hpp"
+
+namespace {
+    ttd::DeductionServer* server = nullptr;
+
+    // --workers takes a thread count from 1 to maxWorkers, in decimal and
+    // nothing else.
+    constexpr unsigned long maxWorkers = 1024;
+
+    bool parseWorkers(const char* text, std::size_t& workers) {
+        if (*text < '0' || *text > '9') {
+            return false;
+        }
+        char* end = nullptr;
+        errno = 0;
+        unsigned long const value = std::strtoul(text, &end, 10);
+        if (errno != 0 || *end != '\0' || value == 0 || value > maxWorkers) {
+            return false;
+        }
+        workers = value;
+        return true;
+    }
+
+    extern "C" void onSignal(int) {
+        if (server != nullptr) {
+            server->stop();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = nullptr;
+    std::size_t workers = std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) {
+            if (!parseWorkers(argv[++i], workers)) {
+                std::fprintf(stderr, "--workers takes a number of threads from 1 to %lu, not %s\n", maxWorkers, argv[i]);
+                return 1;
+            }
+        } else if (path == nullptr && !arg.empty() && arg[0] != '-') {
+            path = argv[i];
+        } else {
+            path = nullptr;
+            break;
+        }
+    }
+    if (path == nullptr) {
+        std::fprintf(stderr, "usage: %s <socket path> [--workers N]\n", argv[0]);
+        return 1;
+    }
+
+    try {
+        ttd::DeductionServer instance(path, workers);
+        server = &instance;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+        std::signal(SIGPIPE, SIG_IGN);
+        instance.run();
+        server = nullptr;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what());
+        return 1;
+    }
+}
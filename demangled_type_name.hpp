@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <mutex>
+#include <string_view>
+#include <typeinfo>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define TTD_HAS_CXA_DEMANGLE
+#endif
+
+#include "report_stats.hpp"
+#include "scrub_type_name.hpp"
+
+// For the parts of name generation that do not depend on the type: one copy
+// for all types, called rather than inlined into every typeName<T>.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TTD_NOINLINE __declspec(noinline)
+#else
+#define TTD_NOINLINE __attribute__((noinline))
+#endif
+
+// Type names from typeid and the C++ ABI's demangler, without boost.
+//
+// typeid drops top-level cv-qualifiers and references, so T is wrapped in a
+// class template first; its demangled name carries T intact between the
+// first '<' and the last '>'. The demangler writes into a buffer that belongs
+// to the thread and grows as needed, so there is no malloc and free per name.
+// Where typeid's name is already readable (MSVC), it is used as is.
+//
+// The names are the same as boost::typeindex::type_id_with_cvr's once both
+// go through ttd::scrubTypeName: the boost-vs-native-names test compares the
+// two reports byte for byte. Both are east const (`int const*`), where the
+// default report's constexpr names are west const (`const int*`), so the
+// native report differs from the default one in const placement.
+
+namespace ttd {
+    // Copies a name into an arena kept for the life of the process. Keeping a
+    // name is then a pointer bump rather than a heap block of its own.
+    inline std::string_view internTypeName(std::string_view name) {
+        static std::mutex mutex;
+        static std::pmr::monotonic_buffer_resource arena(16 * 1024);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        char* const copy = static_cast<char*>(arena.allocate(name.size() + 1, 1));
+        std::memcpy(copy, name.data(), name.size());
+        copy[name.size()] = '\0';
+        return std::string_view(copy, name.size());
+    }
+
+    namespace detail {
+        template <typename T>
+        struct CvrTag { };
+
+        struct DemangleBuffer {
+            char* chars = nullptr;
+            std::size_t capacity = 0;
+
+            DemangleBuffer() = default;
+            DemangleBuffer(const DemangleBuffer&) = delete;
+            DemangleBuffer& operator=(const DemangleBuffer&) = delete;
+
+            ~DemangleBuffer() {
+                std::free(chars);
+            }
+        };
+
+        // Returns the demangled name in the thread's buffer, valid until the
+        // thread's next call; empty if it cannot be demangled.
+        inline std::string_view demangle(const char* mangled) {
+            thread_local DemangleBuffer buffer;
+#ifdef TTD_HAS_CXA_DEMANGLE
+            int status = 0;
+            std::size_t capacity = buffer.capacity;
+            // Reallocates the buffer if it is too small and then reports the
+            // new capacity; leaves both alone otherwise.
+            char* const chars = abi::__cxa_demangle(mangled, buffer.chars, &capacity, &status);
+            if (status != 0 || chars == nullptr) {
+                return std::string_view();
+            }
+            buffer.chars = chars;
+            buffer.capacity = capacity;
+            return std::string_view(chars, std::strlen(chars));
+#else
+            // Already readable; copied so the caller may scrub it in place.
+            std::size_t const size = std::strlen(mangled);
+            if (size + 1 > buffer.capacity) {
+                char* const chars = static_cast<char*>(std::realloc(buffer.chars, size + 1));
+                if (chars == nullptr) {
+                    return std::string_view();
+                }
+                buffer.chars = chars;
+                buffer.capacity = size + 1;
+            }
+            std::memcpy(buffer.chars, mangled, size + 1);
+            return std::string_view(buffer.chars, size);
+#endif
+        }
+
+        // The scrubbed name inside a demangled CvrTag<...>; see
+        // demangledTypeName.
+        TTD_NOINLINE inline std::string_view unwrapDemangled(const char* mangled) {
+            std::string_view const wrapped = demangle(mangled);
+            std::size_t const open = wrapped.find('<');
+            std::size_t const close = wrapped.rfind('>');
+            if (open == std::string_view::npos || close == std::string_view::npos || close <= open) {
+                return std::string_view();
+            }
+
+            // The demangler's buffer is the thread's own, so it is scrubbed in place.
+            TTD_STATS_SCOPE(scrub);
+            char* const name = const_cast<char*>(wrapped.data()) + open + 1;
+            return std::string_view(name, scrubTypeName(name, close - open - 1));
+        }
+    }
+
+    // The scrubbed name of T, in the thread's buffer and valid until the
+    // thread's next call. Not cached: every call demangles.
+    template <typename T>
+    std::string_view demangledTypeName() {
+        return detail::unwrapDemangled(typeid(detail::CvrTag<T>).name());
+    }
+}
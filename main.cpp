@@ -1,763 +1,461 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <memory_resource>
 #include <type_traits>
-#include <regex>
-
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "output_sink.hpp"
+#include "report_cases.hpp"
+#include "report_stats.hpp"
+#include "static_report.hpp"
+#include "work_stealing_pool.hpp"
+
+// TTD_NATIVE_NAMES builds the report without boost, with its names from the
+// native demangler; TTD_BOOST_NAMES takes them from boost at runtime instead
+// of from the constexpr backend.
+#if defined(TTD_BOOST_NAMES)
 #define ENABLE_BOOST
-
-#ifdef ENABLE_BOOST
-#include <boost/type_index.hpp>
-#else
-namespace boost {
-    namespace typeindex {
-        template <typename T>
-        struct type_id_with_cvr {
-            std::string pretty_name() const {
-                return "";
-            }
-        };
-    }
-}
+#elif !defined(TTD_NATIVE_NAMES)
+#define ENABLE_BOOST
+#define ENABLE_CONSTEXPR_TYPE_NAME
 #endif
 
-struct TemplateTypeInfos {
-    std::string param;
-    std::string T;
-};
-
-std::string remove__ptr64(const std::string& s) {
-    std::regex re(R"(\b(__ptr64)\b)");
-    return std::regex_replace(s, re, "");
-}
+#include "pass_by.hpp"
 
-template <typename T>
-TemplateTypeInfos passByValue(T t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
-
-template <typename T>
-TemplateTypeInfos passByRef(T& t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
-
-template <typename T>
-TemplateTypeInfos passByURef(T&& t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
-
-template <typename T>
-TemplateTypeInfos passByPtr(T* t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
-
-template <typename T>
-TemplateTypeInfos passByCPtr(T const* t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
+#ifdef TTD_COUNT_ALLOCATIONS
+#include "allocation_counter.hpp"
+#endif
 
-template <typename T>
-TemplateTypeInfos passByCRef(T const& t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
-}
+// Names of one case; param and T are null when the case does not deduce. The
+// expression and category are known at compile time, so they are just
+// constants in the table.
+struct CaseNames {
+    std::string_view (*arg)();
+    std::string_view expression;
+    std::string_view category;
+    std::string_view (*param)();
+    std::string_view (*T)();
+};
 
-template <typename T>
-TemplateTypeInfos passByCRRef(T const&& t) {
-    return {
-        remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(t)>().pretty_name()),
-        remove__ptr64(boost::typeindex::type_id_with_cvr<T>().pretty_name()),
-    };
+template <typename Case>
+constexpr CaseNames caseNamesOf() {
+    if constexpr (Case::viable) {
+        return { &typeName<typename Case::arg>, Case::expression, ttd::valueCategoryName(Case::category),
+                 &typeName<typename Case::param>, &typeName<typename Case::type> };
+    } else {
+        return { &typeName<typename Case::arg>, Case::expression, ttd::valueCategoryName(Case::category), nullptr, nullptr };
+    }
 }
 
-std::ostream& operator<<(std::ostream& os, const TemplateTypeInfos& infos) {
-    std::cout << "  + param type: " << infos.param << std::endl;
-    std::cout << "  + T:          " << infos.T << std::endl;
-    return os;
+template <typename... Cases>
+constexpr std::array<CaseNames, sizeof...(Cases)> caseNames(ttd::TypeList<Cases...>) {
+    return {{ caseNamesOf<Cases>()... }};
 }
 
-void f(void) { }
-
-#define PRINT_INFO(var, func) do { \
-    std::cout << remove__ptr64(boost::typeindex::type_id_with_cvr<decltype(var)>().pretty_name()) \
-            << '\n' << func(var) << std::endl; \
-} while(0);
-
-void printPassByValueInfos() {
-    std::cout << "################################## Pass By Value ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T param);\n" << std::endl;
-
-    {
-        int a = 10;
-        PRINT_INFO(a, passByValue); // Param: int, T: int
-
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByValue); // Param: int*, T: int*
-
-        int& ra = a;
-        PRINT_INFO(ra, passByValue); // Param: int, T: int
+// One section per form. Each case is just an entry in a constant table, so
+// the matrix can grow without adding code.
+template <typename Form>
+constexpr auto caseTable = caseNames(ttd::ReportMatrix::cases<Form>{});
+
+// What one case of the report cost, for --stats.
+// index is the case's position in its section, which tells apart cases
+// whose arguments print alike.
+struct CaseStats {
+    std::string_view section;
+    std::size_t index;
+    std::string_view arg;
+    ttd::stats::Counters counters;
+};
 
-        int&& rra = std::move(a);
-        PRINT_INFO(rra, passByValue); // Param: int, T: int
+// Where this thread's cases are recorded, if anywhere.
+thread_local std::vector<CaseStats>* recordedCases = nullptr;
+
+// Records the counters of one case from construction to destruction.
+class CaseRecording {
+public:
+#ifdef TTD_STATS
+    CaseRecording(std::string_view section, std::size_t index, std::string_view (*arg)())
+        : _section(section), _index(index), _arg(arg) {
+        if (recordedCases != nullptr) {
+            _before = ttd::stats::snapshot();
+        }
     }
 
-    {
-        int const ca = 10;
-        PRINT_INFO(ca, passByValue); // Param: int, T: int
-
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByValue); // Param: int const*, T: int const*
-
-        int const* const pca = &ca;
-        PRINT_INFO(pca, passByValue); // Param: int const*, T: int const*
-
-        int const& cra = ca;
-        PRINT_INFO(cra, passByValue); // Param: int, T: int
-
-        int const&& crra = 10;
-        PRINT_INFO(crra, passByValue); // Param: int, T: int
-
-        // const int& const crca = a; // <- warning C4220: qualifiers on reference are ignored
-        // const int&& const crrca = 10; // <- warning C4220: qualifiers on reference are ignored
+    ~CaseRecording() {
+        if (recordedCases != nullptr) {
+            ttd::stats::Counters const counters = ttd::stats::snapshot() - _before;
+            recordedCases->push_back({ _section, _index, _arg(), counters });
+        }
     }
 
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByValue); // Param: int*, T: int*
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByValue); // Param: int const*, T: int const*
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByValue); // Param: int(*)[2], T: int(*)[2]
-
-        int(* const pcas)[2] = nullptr; // Param: int(*)[2], T: int(*)[2]
-        PRINT_INFO(pcas, passByValue);
-
-        int const(*cpas)[2] = nullptr; // Param: int const(*)[2], T: int const(*)[2]
-        PRINT_INFO(cpas, passByValue);
-
-        int const(* const cpcas)[2] = nullptr; // Param: int const(*)[2], T: int const(*)[2]
-        PRINT_INFO(cpcas, passByValue);
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByValue); // Param: int*, T: int*
-
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByValue); // Param: int const*, T: int const*
-
-        int(&& rras)[2] = std::move(as); // Param: int*, T: int*
-        PRINT_INFO(rras, passByValue);
-
-        int const(&& crras)[2] = std::move(as); // Param: int const*, T: int const*
-        PRINT_INFO(crras, passByValue);
+private:
+    std::string_view _section;
+    std::size_t _index;
+    std::string_view (*_arg)();
+    ttd::stats::Counters _before;
+#else
+    CaseRecording(std::string_view, std::size_t, std::string_view (*)()) { }
+#endif
+};
 
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+// Cases [begin, end) of a section; the first piece carries the banner.
+template <typename Form>
+void printCases(ttd::OutputSink& out, std::size_t begin, std::size_t end) {
+    if (begin == 0) {
+        out << Form::banner;
     }
-
-    {
-        PRINT_INFO(f, passByValue); // Param: void(*)(), T: void(*)()
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(fp, passByValue); // Param: void(*)(), T: void(*)()
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(fcp, passByValue); // Param: void(*)(), T: void(*)()
-
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByValue); // Param: void(*)(), T: void(*)()
-
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByValue); // Param: void(*)(), T: void(*)()
+    for (std::size_t i = begin; i < end; ++i) {
+        const CaseNames& names = caseTable<Form>[i];
+        CaseRecording const recording(Form::name, i, names.arg);
+        TTD_STATS_SCOPE(format);
+        out << names.arg() << '\n';
+        out << "  + expression: " << names.expression << '\n';
+        out << "  + category:   " << names.category << '\n';
+        if (names.param) {
+            out << TemplateTypeInfos{ names.param(), names.T() } << '\n';
+        } else {
+            out << "  + no viable deduction\n\n";
+        }
     }
 }
 
-void printPassByRefInfos() {
-    std::cout << "################################## Pass By Ref ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T& param);\n" << std::endl;
-
-    {
-        int a = 10;
-        PRINT_INFO(a, passByRef); // Param: int&, T: int
-
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByRef); // Param: int*&, T: int*
-
-        int& ra = a;
-        PRINT_INFO(ra, passByRef); // Param: int&, T: int
-
-        int&& rra = std::move(a);
-        PRINT_INFO(rra, passByRef); // Param: int&, T: int
-    }
-
-    {
-        int const ca = 10;
-        PRINT_INFO(ca, passByRef); // Param: int const&, T: int const
-
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByRef); // Param: int const*&, T: int const*
-
-        int const* const pca = &ca;
-        PRINT_INFO(pca, passByRef); // Param: int const* const&, T: int const* const
-
-        int const& cra = ca;
-        PRINT_INFO(cra, passByRef); // Param: int const&, T: int const
-
-        int const&& crra = 10;
-        PRINT_INFO(crra, passByRef); // Param: int const&, T: int const
-
-        // const int& const crca = a; // <- warning C4220: qualifiers on reference are ignored
-        // const int&& const crrca = 10; // <- warning C4220: qualifiers on reference are ignored
-    }
-
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByRef);   // Param: int(&)[2], T: int[2]
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByRef);  // Param: const int(&)[2], T: const int[2]
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByRef);  // Param: int(*&)[2], T: int(*)[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(pcas, passByRef); // Param: int(* const &)[2], T: int(* const)[2]
-
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(cpas, passByRef); // Param: int const(*&)[2], T: int const(*)[2]
-
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(cpcas, passByRef); // Param: int const(* const &)[2], T: int const(* const)[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByRef); // Param: int(&)[2], T: int[2]
-
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByRef); // Param: int const(&)[2], T: int const[2]
-
-        int(&& rras)[2] = std::move(as);
-        PRINT_INFO(rras, passByRef); // Param: int(&)[2], T: int[2]
-
-        int const(&& crras)[2] = std::move(as);
-        PRINT_INFO(crras, passByRef); // Param: int const(&)[2], T: int const[2]
-
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-    }
-
-    {
-        PRINT_INFO(f, passByRef); // Param: void(&)(), T: void(void)
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(fp, passByRef); // Param: void(*&)(), T: void(*)()
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(fcp, passByRef); // Param: void(* const &)(), T: void(* const)()
-
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByRef); // Param: void(&)(), T: void(void)
-
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByRef); // Param: void(&)(), T: void(void)
-    }
+template <typename Form>
+void printSection(ttd::OutputSink& out) {
+    printCases<Form>(out, 0, caseTable<Form>.size());
 }
 
-void printPassByURefInfos() {
-    std::cout << "################################## Pass By URef ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T&& param);\n" << std::endl;
-
-    {
-        int a = 10;
-        PRINT_INFO(a, passByURef); // Param: int&, T: int&
-        PRINT_INFO(std::move(a), passByURef); // Param: int&&, T: int
-
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByURef); // Param: int*&, T: int*&
-        PRINT_INFO(std::move(pa), passByURef); // Param: int*&&, T: int*
-
-        int& ra = a;
-        PRINT_INFO(ra, passByURef); // Param: int&, T: int&
-        PRINT_INFO(std::move(ra), passByURef); // Param: int&&, T: int
-
-        int&& rra = std::move(a);
-        PRINT_INFO(rra, passByURef); // Param: int&, T: int&
-        PRINT_INFO(std::move(rra), passByURef); // Param: int&&, T: int
-    }
-
-    {
-        int const ca = 10;
-        PRINT_INFO(ca, passByURef); // Param: int const&, T: int const&
-        PRINT_INFO(std::move(ca), passByURef); // Param: int const&&, T: int const
-
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByURef); // Param: int const*&, T: int const*&
-        PRINT_INFO(std::move(cpa), passByURef); // Param: int const*&&, T: int const*
-
-        int const* const pca = &ca;
-        PRINT_INFO(pca, passByURef); // Param: int const* const&, T: int const* const&
-        PRINT_INFO(std::move(pca), passByURef); // Param: int const* const&&, T: int const* const
-
-        int const& cra = ca;
-        PRINT_INFO(cra, passByURef); // Param: int const&, T: int const&
-        PRINT_INFO(std::move(cra), passByURef); // Param: int const&&, T: int const
-
-        int const&& crra = 10;
-        PRINT_INFO(crra, passByURef); // Param: int const&, T: int const&
-        PRINT_INFO(std::move(crra), passByURef); // Param: int const&&, T: int const
-
-        // const int& const crca = a; // <- warning C4220: qualifiers on reference are ignored
-        // const int&& const crrca = 10; // <- warning C4220: qualifiers on reference are ignored
-    }
-
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByURef); // Param: int(&)[2], T: int(&)[2]
-        PRINT_INFO(std::move(as), passByURef); // Param: int(&&)[2], T: int[2]
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByURef); // Param: int const(&)[2], T: int const(&)[2]
-        PRINT_INFO(std::move(cas), passByURef); // Param: int const(&&)[2], T: int const[2]
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByURef);  // Param: int (*&)[2], T: int (*&)[2]
-        PRINT_INFO(std::move(pas), passByURef); // Param: int(*&&)[2], T: int(*)[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(pcas, passByURef); // Param: int (* const &)[2], T: int (* const &)[2]
-        PRINT_INFO(std::move(pcas), passByURef); // Param: int(* const&&)[2], T: int(* const)[2]
-
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(cpas, passByURef); // Param: int const(*&)[2], T: int const(*&)[2]
-        PRINT_INFO(std::move(cpas), passByURef); // Param: int const(*&&)[2], T: int const(*)[2]
-
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(cpcas, passByURef); // Param: int const(* const &)[2], T: int const(* const&)[2]
-        PRINT_INFO(std::move(cpcas), passByURef); // Param: int const(* const&&)[2], T: int const(* const)[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByURef); // Param: int(&)[2], T: int(&)[2]
-        PRINT_INFO(std::move(ras), passByURef); // Param: int(&&)[2], T: int[2]
+template <typename... Forms>
+void printSections(ttd::OutputSink& out, ttd::TypeList<Forms...>) {
+    (printSection<Forms>(out), ...);
+}
 
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByURef); // Param: int const(&)[2], T: int const(&)[2]
-        PRINT_INFO(std::move(cras), passByURef); // Param: int const(&&)[2], T: int const[2]
+// A slice of one section, the unit of work of a parallel report.
+struct ReportPiece {
+    void (*print)(ttd::OutputSink&, std::size_t, std::size_t);
+    std::size_t begin;
+    std::size_t end;
+};
 
-        int(&& rras)[2] = std::move(as);
-        PRINT_INFO(rras, passByURef); // Param: int(&)[2], T: int(&)[2]
-        PRINT_INFO(std::move(rras), passByURef); // Param: int (&&)[2], T: int[2]
+constexpr std::size_t casesPerPiece = 64;
 
-        int const(&& crras)[2] = std::move(as);
-        PRINT_INFO(crras, passByURef);// Param: int const(&)[2], T: int const(&)[2]
-        PRINT_INFO(std::move(crras), passByURef); // Param: int const(&&)[2], T: int const[2]
+// A generous guess at the text of one case, so a piece's buffer is usually
+// sized right the first time.
+constexpr std::size_t bytesPerCase = 192;
 
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+template <typename Form>
+void addPieces(std::vector<ReportPiece>& pieces) {
+    std::size_t const count = caseTable<Form>.size();
+    for (std::size_t begin = 0; begin == 0 || begin < count; begin += casesPerPiece) {
+        pieces.push_back({ &printCases<Form>, begin, std::min(count, begin + casesPerPiece) });
     }
+}
 
-    {
-        PRINT_INFO(f, passByURef); // Param: void(&)(void), T: void(&)(void)
-        PRINT_INFO(std::move(f), passByURef); // Param void(&)(void), T: void(&)(void), MSVC is wrong
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(fp, passByURef); // Param: void(*&)(void), T: void(*&)()
-        PRINT_INFO(std::move(fp), passByURef); // Param: void(*&&)(void), T: void(*)(void)
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(fcp, passByURef); // Param: void(* const&)(void), T: void(* const&)()
-        PRINT_INFO(std::move(fcp), passByURef); // Param: void(* const &&)(void), T: void(* const)(void)
+template <typename... Forms>
+std::vector<ReportPiece> reportPieces(ttd::TypeList<Forms...>) {
+    std::vector<ReportPiece> pieces;
+    (addPieces<Forms>(pieces), ...);
+    return pieces;
+}
 
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByURef); // Param: void(&)(void), T: void(&)()
-        PRINT_INFO(std::move(fr), passByURef); // Param void(&)(void), T: void(&)(void), MSVC is wrong
+// The auto, decltype(auto), lambda, binding and CTAD sections. They are
+// compiled into one constant with constexpr names whatever the backend, so
+// printing them is a single write.
+void printContextSections(ttd::OutputSink& out) {
+    using Context = ttd::StaticReport<ttd::ContextMatrix>;
+    out << std::string_view(Context::text.data(), Context::text.size());
+}
 
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByURef); // Param: void(&)(void), T: void(&)()
-        PRINT_INFO(std::move(frr), passByURef); // Param void(&)(void), T: void(&)(void), MSVC is wrong
-    }
+// The same text case by case from the constant's pieces, so --stats records
+// the context cases like the passBy* ones.
+template <typename Form, typename... Cases>
+void printContextSection(ttd::OutputSink& out, ttd::TypeList<Cases...>) {
+    out << Form::banner;
+    std::size_t index = 0;
+    ([&] {
+        CaseRecording const recording(Form::name, index++, &ttd::constexprTypeName<typename Cases::arg>);
+        TTD_STATS_SCOPE(format);
+        for (std::string_view piece : ttd::StaticRow<Cases>::pieces) {
+            out << piece;
+        }
+    }(), ...);
 }
 
-void printPassByPtrInfos() {
-    std::cout << "################################## Pass By Pointer ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T* param);\n" << std::endl;
+template <typename... Forms>
+void printContextSectionsByCase(ttd::OutputSink& out, ttd::TypeList<Forms...>) {
+    (printContextSection<Forms>(out, ttd::ContextMatrix::cases<Forms>{}), ...);
+}
 
-    {
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByPtr); // Param: int*, T: int
+// Renders every piece into its own buffer on `jobs` threads, then writes the
+// buffers in report order, so the output is the same as the serial one. Each
+// buffer lives in an arena of its own that is dropped in one piece at the end.
+//
+// With stats, every case's counters are appended to it, in report order.
+void printReport(ttd::OutputSink& out, std::size_t jobs, std::vector<CaseStats>* stats = nullptr) {
+    if (jobs <= 1) {
+        if (stats != nullptr) {
+            stats->reserve(stats->size() + ttd::ReportMatrix::combinationCount + ttd::ContextMatrix::combinationCount);
+            ttd::stats::enable(true);
+            recordedCases = stats;
+        }
+        printSections(out, ttd::ReportMatrix::forms{});
+        if (stats != nullptr) {
+            printContextSectionsByCase(out, ttd::ContextMatrix::forms{});
+        } else {
+            printContextSections(out);
+        }
+        recordedCases = nullptr;
+        return;
     }
 
-    {
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByPtr); // Param: int const*, T: int const
-
-        const int* const cpca = nullptr;
-        PRINT_INFO(cpca, passByPtr); // Param: int const*, T: int const
+    std::vector<ReportPiece> const pieces = reportPieces(ttd::ReportMatrix::forms{});
+    std::deque<std::pmr::monotonic_buffer_resource> arenas;
+    std::vector<ttd::MemorySink> buffers;
+    buffers.reserve(pieces.size());
+    for (const ReportPiece& piece : pieces) {
+        buffers.emplace_back(&arenas.emplace_back((piece.end - piece.begin + 1) * bytesPerCase));
     }
-
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByPtr); // Param: int*, T: int
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByPtr); // Param: int const*, T: int const
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByPtr); // Param: int(*)[2], T: int[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(pcas, passByPtr); // Param: int(*)[2], T: int[2]
-
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(cpas, passByPtr); // Param: int const(*)[2], T: int const[2]
-
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(cpcas, passByPtr); // Param: int const(*)[2], T: int const[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByPtr); // Param: int*, T: int
-
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByPtr); // Param: int const*, T: int const
-
-        int(&& rras)[2] = std::move(as);
-        PRINT_INFO(rras, passByPtr); // Param: int*, T: int
-
-        int const(&& crras)[2] = std::move(as);
-        PRINT_INFO(crras, passByPtr); // Param: int const*, T: int const
-
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+    std::vector<std::vector<CaseStats>> pieceStats(stats != nullptr ? pieces.size() : 0);
+
+    ttd::WorkStealingPool pool(jobs);
+    pool.run(pieces.size(), [&](std::size_t i) {
+        if (stats != nullptr) {
+            pieceStats[i].reserve(pieces[i].end - pieces[i].begin);
+            ttd::stats::enable(true);
+            recordedCases = &pieceStats[i];
+        }
+        buffers[i].reserve((pieces[i].end - pieces[i].begin + 1) * bytesPerCase);
+        pieces[i].print(buffers[i], pieces[i].begin, pieces[i].end);
+        recordedCases = nullptr;
+    });
+    for (const ttd::MemorySink& buffer : buffers) {
+        out << buffer.str();
     }
-
-    {
-        PRINT_INFO(f, passByPtr); // Param: void(*)(), T: void(void)
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(fp, passByPtr); // Param: void(*)(), T: void(void)
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(fcp, passByPtr); // Param: void(*), T: void(void)
-
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByPtr); // Param: void(*), T: void(void)
-
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByPtr); // Param: void(*), T: void(void)
+    if (stats == nullptr) {
+        printContextSections(out);
+        return;
     }
+    for (const std::vector<CaseStats>& cases : pieceStats) {
+        stats->insert(stats->end(), cases.begin(), cases.end());
+    }
+    stats->reserve(stats->size() + ttd::ContextMatrix::combinationCount);
+    ttd::stats::enable(true);
+    recordedCases = stats;
+    printContextSectionsByCase(out, ttd::ContextMatrix::forms{});
+    recordedCases = nullptr;
 }
 
-void printPassByCPtrInfos() {
-    std::cout << "################################## Pass By Const Pointer ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T const* param);\n" << std::endl;
+#ifdef TTD_STATS
+// Constexpr names are scrubbed by the compiler and never allocate, so only
+// the boost and native builds have anything in the scrub and bytes columns.
+#if defined(ENABLE_CONSTEXPR_TYPE_NAME)
+constexpr const char* nameBackend = "constexpr (no runtime scrubbing or allocation; see the -boost and -native builds)";
+#elif defined(ENABLE_BOOST)
+constexpr const char* nameBackend = "boost";
+#else
+constexpr const char* nameBackend = "native demangler";
+#endif
 
-    {
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByCPtr); // Param: int const*, T: int
+// A table per section and the slowest cases on stderr, so the report itself
+// is unchanged; folded stacks (report;section;#index argument;phase
+// nanoseconds) for flamegraph.pl in foldedPath. The context sections always
+// use constexpr names.
+void printStats(const std::vector<CaseStats>& cases, const std::string& foldedPath) {
+    using ttd::stats::Counters;
+    using ttd::stats::phaseCount;
+
+    std::vector<std::pair<std::string_view, Counters>> sections;
+    std::vector<std::size_t> caseCounts;
+    Counters total;
+    for (const CaseStats& c : cases) {
+        if (sections.empty() || sections.back().first != c.section) {
+            sections.emplace_back(c.section, Counters());
+            caseCounts.push_back(0);
+        }
+        sections.back().second += c.counters;
+        ++caseCounts.back();
+        total += c.counters;
     }
 
-    {
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByCPtr); // Param: int const*, T: int
-
-        const int* const cpca = nullptr;
-        PRINT_INFO(cpca, passByCPtr); // Param: int const*, T: int
+    auto row = [](std::string_view name, std::size_t count, const Counters& counters) {
+        std::fprintf(stderr, "%-14.*s %6zu %12.1f %12.1f %12.1f %12.1f %10llu\n", int(name.size()), name.data(), count,
+                     counters.ns[0] / 1e3, counters.ns[1] / 1e3, counters.ns[2] / 1e3, counters.totalNs() / 1e3,
+                     static_cast<unsigned long long>(counters.bytes));
+    };
+    std::fprintf(stderr, "names: %s\n\n", nameBackend);
+    std::fprintf(stderr, "%-14s %6s %12s %12s %12s %12s %10s\n", "section", "cases", "names us", "scrub us", "format us", "total us", "bytes");
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        row(sections[i].first, caseCounts[i], sections[i].second);
     }
+    row("total", cases.size(), total);
 
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByCPtr); // Param: int const*, T: int
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByCPtr); // Param: int const*, T: int
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByCPtr); // Param: int const(*)[2], T: int[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(pcas, passByCPtr); // Param: int const(*)[2], T: int[2]
-
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(cpas, passByCPtr); // Param: int const(*)[2], T: int[2]
-
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(cpcas, passByCPtr); // Param: int const(*)[2], T: int[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByCPtr); // Param: int const*, T: int
-
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByCPtr); // Param: int const*, T: int
-
-        int(&& rras)[2] = std::move(as);
-        PRINT_INFO(rras, passByCPtr); // Param: int const*, T: int
-
-        int const(&& crras)[2] = std::move(as);
-        PRINT_INFO(crras, passByCPtr); // Param: int const*, T: int
-
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+    std::vector<const CaseStats*> slowest;
+    for (const CaseStats& c : cases) {
+        slowest.push_back(&c);
     }
-
-    {
-        // no matching function for call to 'passByCPtr'
-        // could not match 'const T *' against 'void (*)()
-        //PRINT_INFO(f, passByCPtr);
-
-        //void (*fp)() = nullptr;
-        //PRINT_INFO(fp, passByCPtr);
-
-        //void (* const fcp)() = nullptr;
-        //PRINT_INFO(fcp, passByCPtr);
-
-        //void(&fr)() = f;
-        //PRINT_INFO(fr, passByCPtr);
-
-        //void(&& frr)() = f;
-        //PRINT_INFO(frr, passByCPtr);
+    std::size_t const shown = std::min<std::size_t>(10, slowest.size());
+    std::partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(), [](const CaseStats* a, const CaseStats* b) {
+        return a->counters.totalNs() > b->counters.totalNs();
+    });
+    std::fprintf(stderr, "\nslowest cases:\n");
+    for (std::size_t i = 0; i < shown; ++i) {
+        const CaseStats& c = *slowest[i];
+        std::fprintf(stderr, "  %-14.*s %3zu %-32.*s %10.1f us\n", int(c.section.size()), c.section.data(), c.index,
+                     int(c.arg.size()), c.arg.data(), c.counters.totalNs() / 1e3);
     }
-}
-
-void printPassByCRefInfos() {
-    std::cout << "################################## Pass By Const Reference ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T const& param);\n" << std::endl;
-
-    {
-        int a = 10;
-        PRINT_INFO(a, passByCRef); // Param: int const&, T: int
-
-        int* pa = nullptr;
-        PRINT_INFO(pa, passByCRef); // Param: int* const&, T: int*
 
-        int& ra = a;
-        PRINT_INFO(ra, passByCRef); // Param: int const&, T: int
-
-        int&& rra = std::move(a);
-        PRINT_INFO(rra, passByCRef); // Param: int const&, T: int
+    std::ofstream folded(foldedPath);
+    for (const CaseStats& c : cases) {
+        for (std::size_t phase = 0; phase < phaseCount; ++phase) {
+            if (c.counters.ns[phase] > 0) {
+                folded << "report;" << c.section << ";#" << c.index << ' ' << c.arg << ';' << ttd::stats::phaseNames[phase]
+                       << ' ' << c.counters.ns[phase] << '\n';
+            }
+        }
     }
-
-    {
-        int const ca = 10;
-        PRINT_INFO(ca, passByCRef); // Param: int const &, T: int
-
-        int const* cpa = nullptr;
-        PRINT_INFO(cpa, passByCRef); // Param: int const *const &, T: int const *
-
-        int const* const pca = &ca;
-        PRINT_INFO(pca, passByCRef); // Param: int const* const &, T: int const*
-
-        int const& cra = ca;
-        PRINT_INFO(cra, passByCRef); // Param: int const &, T: int
-
-        int const&& crra = 10;
-        PRINT_INFO(crra, passByCRef); // Param: int const &, T: int
-
-        // const int& const crca = a; // <- warning C4220: qualifiers on reference are ignored
-        // const int&& const crrca = 10; // <- warning C4220: qualifiers on reference are ignored
+    if (!folded) {
+        throw std::runtime_error("cannot write " + foldedPath);
     }
+}
+#endif
 
-    {
-        int as[2]{};
-        PRINT_INFO(as, passByCRef); // Param: int const(&)[2], T: int[2]
-
-        int const cas[2]{};
-        PRINT_INFO(cas, passByCRef); // Param: int const(&)[2], T: int [2]
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(pas, passByCRef); // Param: int (*const &)[2], T: int(*)[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(pcas, passByCRef); // Param: int (*const &)[2], T: int(*)[2]
-
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(cpas, passByCRef); // Param: int const(* const&)[2], T: int const(*)[2]
-
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(cpcas, passByCRef); // Param: int const(* const&)[2], T: int const(*)[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(ras, passByCRef); // Param: int const(&)[2], T: int[2]
-
-        int const(&cras)[2] = as;
-        PRINT_INFO(cras, passByCRef); // Param: int const(&)[2], T: int[2]
-
-        int(&& rras)[2] = std::move(as);
-        PRINT_INFO(rras, passByCRef); // Param: int const(&)[2], T: int[2]
-
-        int const(&& crras)[2] = std::move(as);
-        PRINT_INFO(crras, passByCRef); // Param: int const(&)[2], T: int[2]
-
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+#ifdef TTD_COUNT_ALLOCATIONS
+// Renders the report once so every name is computed, then again into a buffer
+// of the right size, counting heap allocations. The second pass must not
+// allocate at all.
+//
+// Then once more on allocationCheckJobs threads. Setting up the pool and the
+// piece buffers allocates by design, so that pass counts per case instead:
+// no warm case may allocate on a worker thread.
+constexpr std::size_t allocationCheckJobs = 4;
+
+int checkAllocations() {
+    ttd::MemorySink warmup;
+    printReport(warmup, 1);
+
+    ttd::MemorySink out;
+    out.reserve(warmup.str().size());
+    std::size_t const before = ttd::allocationCount();
+    printReport(out, 1);
+    std::size_t const allocations = ttd::allocationCount() - before;
+
+    ttd::MemorySink parallel;
+    std::vector<CaseStats> cases;
+    printReport(parallel, allocationCheckJobs, &cases);
+    std::size_t allocatingCases = 0;
+    for (const CaseStats& c : cases) {
+        allocatingCases += c.counters.bytes > 0;
     }
 
-    {
-        PRINT_INFO(f, passByCRef); // Param: void(&)(void), T: void(void)
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(fp, passByCRef); // Param: void(*const&)(void), T: void(*)()
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(fcp, passByCRef); // Param: void(*const&)(void), T: void(*)()
-
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByCRef); // Param: void(&)(), T: void(void)
-
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByCRef); // Param void(&)(), T: void(void)
-    }
+    std::cout << "cases:       " << ttd::ReportMatrix::combinationCount << '\n'
+              << "allocations: " << allocations << '\n'
+              << "cases allocating on " << allocationCheckJobs << " threads: " << allocatingCases
+              << " of " << cases.size() << '\n';
+    return allocations == 0 && allocatingCases == 0 && cases.size() == ttd::ReportMatrix::combinationCount
+        && out.str() == warmup.str() && parallel.str() == warmup.str() ? 0 : 1;
 }
+#endif
 
-void printPassByCRRefInfos() {
-    std::cout << "################################## Pass By Const Rvalue Reference ##################################" << std::endl;
-    std::cout << "template <typename T>" << std::endl;
-    std::cout << "void f(T const&& param);\n" << std::endl;
-
-    {
-        int a = 10;
-        PRINT_INFO(std::move(a), passByCRRef); // Param: int const &&, T: int
-
-        int* pa = nullptr;
-        PRINT_INFO(std::move(pa), passByCRRef); // Param: int* const&&, T: int*
-
-        int& ra = a;
-        PRINT_INFO(std::move(ra), passByCRRef); // Param: int const&&, T: int
-
-        int&& rra = std::move(ra);
-        PRINT_INFO(std::move(rra), passByCRRef); // Param: int const&&, T: int
+// Sizes of the case matrices. These count argument x form combinations and
+// the viable ones among them, not template instantiations: a viable
+// combination instantiates the probes it names, and a combination that does
+// not deduce instantiates nothing beyond the failed substitution.
+void printMatrixStats(ttd::OutputSink& out) {
+    using Matrix = ttd::ReportMatrix;
+    out << "argument kinds:                " << std::to_string(Matrix::argumentCount) << '\n';
+    out << "forms:                         " << std::to_string(Matrix::formCount) << '\n';
+    out << "combinations:                  " << std::to_string(Matrix::combinationCount) << '\n';
+    out << "viable combinations:           " << std::to_string(Matrix::viableCount) << '\n';
+    out << "context forms:                 " << std::to_string(ttd::ContextMatrix::formCount) << '\n';
+    out << "context combinations:          " << std::to_string(ttd::ContextMatrix::combinationCount) << '\n';
+    out << "viable context combinations:   " << std::to_string(ttd::ContextMatrix::viableCount) << '\n';
+}
 
-        // Cannot bind lvalue to rvalue reference
-        //PRINT_INFO(a, passByCRRef);
-        //PRINT_INFO(pa, passByCRRef);
-        //PRINT_INFO(ra, passByCRRef);
-        //PRINT_INFO(rra, passByCRRef);
+// --jobs takes a thread count from 1 to maxJobs, in decimal and nothing else.
+constexpr unsigned long maxJobs = 1024;
 
+bool parseJobs(const char* text, std::size_t& jobs) {
+    if (*text < '0' || *text > '9') {
+        return false;
     }
-
-    {
-        int const ca = 10;
-        PRINT_INFO(std::move(ca), passByCRRef); // Param: int const &&, T: int
-
-        int const* cpa = nullptr;
-        PRINT_INFO(std::move(cpa), passByCRRef); // Param: int const* const&&, T: int const*
-
-        int const* const pca = &ca;
-        PRINT_INFO(std::move(pca), passByCRRef); // Param: int const* const&&, T: int const*
-
-        int const& cra = ca;
-        PRINT_INFO(std::move(cra), passByCRRef); // Param: int const &&, T: int
-
-        int const&& crra = 10;
-        PRINT_INFO(std::move(crra), passByCRRef); // Param: int const &&, T: int
-
-        // Cannot bind lvalue to rvalue reference
-        //PRINT_INFO(ca, passByCRRef);
-        //PRINT_INFO(cpa, passByCRRef);
-        //PRINT_INFO(pca, passByCRRef);
-        //PRINT_INFO(cra, passByCRRef);
-        //PRINT_INFO(crra, passByCRRef);
-
-        // const int& const crca = a; // <- warning C4220: qualifiers on reference are ignored
-        // const int&& const crrca = 10; // <- warning C4220: qualifiers on reference are ignored
+    char* end = nullptr;
+    errno = 0;
+    unsigned long const value = std::strtoul(text, &end, 10);
+    if (errno != 0 || *end != '\0' || value == 0 || value > maxJobs) {
+        return false;
     }
+    jobs = value;
+    return true;
+}
 
-    {
-        int as[2]{};
-        PRINT_INFO(std::move(as), passByCRRef); // Param: int const(&&)[2], T: int[2]
-
-        int const cas[2]{};
-        PRINT_INFO(std::move(cas), passByCRRef); // Param: int const(&&)[2], T: int[2]
-
-        int(*pas)[2] = nullptr;
-        PRINT_INFO(std::move(pas), passByCRRef); // Param: int(* const&&)[2], T: int(*)[2]
-
-        int(* const pcas)[2] = nullptr;
-        PRINT_INFO(std::move(pcas), passByCRRef); // Param: int(* const&&)[2], T: int(*)[2]
-        
-        int const(*cpas)[2] = nullptr;
-        PRINT_INFO(std::move(cpas), passByCRRef); // Param: int const(* const&&)[2], T: int const(*)[2]
-        
-        int const(* const cpcas)[2] = nullptr;
-        PRINT_INFO(std::move(cpcas), passByCRRef); // Param: int const(*const &&)[2], T: int const(*)[2]
-
-        int(&ras)[2] = as;
-        PRINT_INFO(std::move(ras), passByCRRef); // Param: int const(&&)[2], T: int[2]
-        
-        int const(&cras)[2] = as;
-        PRINT_INFO(std::move(as), passByCRRef); // Param: int const(&&)[2], T: int const[2]
-
-        // Cannot bind lvalue to rvalue reference
-        //PRINT_INFO(as, passByCRRef);
-        //PRINT_INFO(cas, passByCRRef);
-        //PRINT_INFO(pas, passByCRRef);
-        //PRINT_INFO(pcas, passByCRRef);
-        //PRINT_INFO(cpas, passByCRRef);
-        //PRINT_INFO(cpcas, passByCRRef);
-        //PRINT_INFO(ras, passByCRRef);
-        //PRINT_INFO(cras, passByCRRef);
-        // 
-        //int(const* cpa)[2] = &a; // error: grammer...
-        //int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
-        //const int(& const rca)[2] = a; // <- warning C4220: qualifiers on reference are ignored
+int main(int argc, char* argv[]) {
+    std::string outputPath;
+    bool matrixStats = false;
+    std::size_t jobs = 1;
+    std::string foldedPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view const arg = argv[i];
+        if ((arg == "-o" || arg == "--output") && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--matrix-stats") {
+            matrixStats = true;
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            if (!parseJobs(argv[++i], jobs)) {
+                std::cerr << "--jobs takes a number of threads from 1 to " << maxJobs << ", not " << argv[i] << std::endl;
+                return 1;
+            }
+#ifdef TTD_STATS
+        } else if (arg == "--stats" && i + 1 < argc) {
+            foldedPath = argv[++i];
+#endif
+#ifdef TTD_COUNT_ALLOCATIONS
+        } else if (arg == "--count-allocations") {
+            return checkAllocations();
+#endif
+        } else {
+            std::cerr << "usage: " << argv[0] << " [-o|--output <file>] [--matrix-stats] [--jobs N]"
+#ifdef TTD_STATS
+                      << " [--stats <folded stacks file>]"
+#endif
+                      << std::endl;
+            return 1;
+        }
     }
 
-    {
-        PRINT_INFO(f, passByCRRef); // Param: void(&&)(void), T: void(void)
-        PRINT_INFO(std::move(f), passByCRRef); // Param: void(&&)(void), T: void(void)
-
-        void (*fp)() = nullptr;
-        PRINT_INFO(std::move(fp), passByCRRef); // Param: void(* const &&)(void), T: void(*)(void)
-
-        void (* const fcp)() = nullptr;
-        PRINT_INFO(std::move(fcp), passByCRRef); // Param: void(* const &&)(void), T: void(*)(void)
-
-        void(&fr)() = f;
-        PRINT_INFO(fr, passByCRRef); // Param: void(&&)(void), T: void(void)
-        PRINT_INFO(std::move(fr), passByCRRef); // Param: void(&&)(void), T: void(void)
-
-        void(&& frr)() = f;
-        PRINT_INFO(frr, passByCRRef); // Param: void(&&)(void), T: void(void)
-        PRINT_INFO(std::move(frr), passByCRRef); // Param: void(&&)(void), T: void(void)
-
+    std::vector<CaseStats> stats;
+    auto print = [&](ttd::OutputSink& out) {
+        if (matrixStats) {
+            printMatrixStats(out);
+        } else {
+            printReport(out, jobs, foldedPath.empty() ? nullptr : &stats);
+        }
+        // The whole report usually fits the sink's buffer, so this is its one
+        // write; a failure must reach the catch below, not the destructor.
+        out.flush();
+    };
 
-        // Cannot bind lvalue to rvalue reference
-        //PRINT_INFO(fp, passByCRRef);
-        //PRINT_INFO(fcp, passByCRRef);
+    try {
+        if (outputPath.empty()) {
+            ttd::FdSink out(1);
+            print(out);
+        } else {
+            ttd::FileSink out(outputPath);
+            print(out);
+        }
+#ifdef TTD_STATS
+        if (!foldedPath.empty()) {
+            printStats(stats, foldedPath);
+        }
+#endif
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
     }
-}
-
-int main() {
-    printPassByValueInfos();
-    printPassByRefInfos();
-    printPassByURefInfos();
-    printPassByPtrInfos();
-    printPassByCPtrInfos();
-    printPassByCRefInfos();
-    printPassByCRRefInfos();
 }
\ No newline at end of file
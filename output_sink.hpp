@@ -0,0 +1,168 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Where the report goes.
+//
+// Every line of the report is written through an OutputSink. The sinks buffer
+// in userspace and never flush per line, so a whole report normally leaves the
+// process in a single write().
+
+namespace ttd {
+    class OutputSink {
+    public:
+        virtual ~OutputSink() = default;
+
+        virtual void write(const char* data, std::size_t size) = 0;
+        virtual void flush() { }
+
+        OutputSink& operator<<(std::string_view s) {
+            write(s.data(), s.size());
+            return *this;
+        }
+
+        OutputSink& operator<<(const char* s) {
+            return *this << std::string_view(s);
+        }
+
+        OutputSink& operator<<(char c) {
+            write(&c, 1);
+            return *this;
+        }
+    };
+
+    // Buffers everything and hands it to a file descriptor on flush(), when the
+    // buffer is full, or on destruction. The destructor cannot report a failed
+    // write, so callers that care flush() before the sink goes away.
+    class FdSink : public OutputSink {
+    public:
+        static constexpr std::size_t defaultCapacity = 1 << 20;
+
+        explicit FdSink(int fd, std::size_t capacity = defaultCapacity) : _fd(fd) {
+            _buffer.reserve(capacity);
+        }
+
+        FdSink(const FdSink&) = delete;
+        FdSink& operator=(const FdSink&) = delete;
+
+        ~FdSink() override {
+            try {
+                flush();
+            } catch (...) {
+            }
+        }
+
+        void write(const char* data, std::size_t size) override {
+            if (_buffer.size() + size > _buffer.capacity()) {
+                flush();
+                if (size > _buffer.capacity()) {
+                    writeAll(data, size);
+                    return;
+                }
+            }
+            _buffer.insert(_buffer.end(), data, data + size);
+        }
+
+        void flush() override {
+            writeAll(_buffer.data(), _buffer.size());
+            _buffer.clear();
+        }
+
+    protected:
+        int _fd;
+
+    private:
+        std::vector<char> _buffer;
+
+        void writeAll(const char* data, std::size_t size) {
+            while (size > 0) {
+#ifdef _WIN32
+                int const written = ::_write(_fd, data, static_cast<unsigned>(size));
+#else
+                ssize_t const written = ::write(_fd, data, size);
+#endif
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(std::string("write failed: ") + std::strerror(errno));
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+        }
+    };
+
+    // An FdSink that owns a file it creates (or truncates).
+    class FileSink : public FdSink {
+    public:
+        explicit FileSink(const std::string& path) : FdSink(openFile(path)) { }
+
+        ~FileSink() override {
+            try {
+                flush();
+            } catch (...) {
+            }
+#ifdef _WIN32
+            ::_close(_fd);
+#else
+            ::close(_fd);
+#endif
+        }
+
+    private:
+        static int openFile(const std::string& path) {
+#ifdef _WIN32
+            int const fd = ::_open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+            int const fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            if (fd < 0) {
+                throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+            }
+            return fd;
+        }
+    };
+
+    // Keeps the output in memory, e.g. to compare a report against a reference.
+    // The text lives in the given memory resource, so a caller can put it in
+    // an arena that goes away in one piece.
+    class MemorySink : public OutputSink {
+    public:
+        explicit MemorySink(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : _data(resource) { }
+
+        void write(const char* data, std::size_t size) override {
+            _data.append(data, size);
+        }
+
+        std::string_view str() const {
+            return _data;
+        }
+
+        void reserve(std::size_t capacity) {
+            _data.reserve(capacity);
+        }
+
+        void clear() {
+            _data.clear();
+        }
+
+    private:
+        std::pmr::string _data;
+    };
+}
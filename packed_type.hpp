@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// A fixed-width encoding of the common types, for bulk deduction.
+//
+// A PackedType is one 64-bit word: a base type with cv, up to three pointer
+// or array layers above it and an optional reference on top. The base is an
+// index into the codec's table of named and function types, so everything the
+// deduction rules look at is a bit field and the rules become masks, shifts
+// and selects (see batch_deduction.hpp).
+//
+//   bits  0-15   base id
+//   bits 16-17   base cv
+//   bits 18-19   number of layers, 0 to 3
+//   bits 20-31   layers, 4 bits each, layer 0 outermost:
+//                bit 0 array, bits 1-2 cv of a pointer
+//   bits 32-47   array bound, at most one array layer
+//   bits 48-49   reference: none, & or &&
+//   bit  50      the base is a function type
+//   bit  63      no type: the deduction does not compile
+//
+// Like the model, an array carries no cv of its own; its cv is that of the
+// layer (or base) below it. Types with more layers, a second array, a bound
+// over 65535 or more than 65536 distinct bases do not fit.
+
+namespace ttd {
+    using PackedType = std::uint64_t;
+
+    namespace packed {
+        constexpr PackedType baseMask = 0xffff;
+        constexpr unsigned baseCvShift = 16;
+        constexpr unsigned countShift = 18;
+        constexpr PackedType countMask = PackedType(3) << countShift;
+        constexpr PackedType countOne = PackedType(1) << countShift;
+        constexpr unsigned layerShift = 20;
+        constexpr unsigned layerBits = 4;
+        constexpr std::size_t maxLayers = 3;
+        constexpr PackedType layersMask = PackedType(0xfff) << layerShift;
+        constexpr PackedType layer0Array = PackedType(1) << layerShift;
+        constexpr unsigned layer0CvShift = layerShift + 1;
+        constexpr unsigned layer1CvShift = layerShift + layerBits + 1;
+        constexpr unsigned boundShift = 32;
+        constexpr PackedType boundMask = PackedType(0xffff) << boundShift;
+        constexpr std::size_t maxBound = 0xffff;
+        constexpr PackedType lvalueReference = PackedType(1) << 48;
+        constexpr PackedType rvalueReference = PackedType(2) << 48;
+        constexpr PackedType referenceMask = PackedType(3) << 48;
+        constexpr PackedType functionBase = PackedType(1) << 50;
+        constexpr PackedType none = PackedType(1) << 63;
+
+        // Every place the top-level cv of a type can live; cv is 1 for const
+        // and 2 for volatile, as in ttd::Cv.
+        constexpr PackedType baseCv = PackedType(3) << baseCvShift;
+        constexpr PackedType layer0Cv = PackedType(3) << layer0CvShift;
+        constexpr PackedType layer1Cv = PackedType(3) << layer1CvShift;
+        constexpr PackedType anyConst = (PackedType(1) << baseCvShift)
+            | (PackedType(1) << layer0CvShift) | (PackedType(1) << layer1CvShift);
+        constexpr PackedType anyVolatile = (PackedType(2) << baseCvShift)
+            | (PackedType(2) << layer0CvShift) | (PackedType(2) << layer1CvShift);
+    }
+}
@@ -0,0 +1,107 @@
+#include "packed_type_codec.hpp"
+
+namespace ttd {
+    PackedType PackedTypeCodec::pack(const Type* type) {
+        auto const found = _packed.find(type);
+        if (found != _packed.end()) {
+            return found->second;
+        }
+        PackedType const packed = encode(type);
+        _packed.emplace(type, packed);
+        return packed;
+    }
+
+    const Type* PackedTypeCodec::unpack(PackedType packed) {
+        if (packed & packed::none) {
+            return nullptr;
+        }
+        auto const found = _unpacked.find(packed);
+        if (found != _unpacked.end()) {
+            return found->second;
+        }
+        const Type* const type = decode(packed);
+        _unpacked.emplace(packed, type);
+        return type;
+    }
+
+    PackedType PackedTypeCodec::encode(const Type* type) {
+        PackedType packed = 0;
+        if (type->kind == TypeKind::lvalueReference) {
+            packed |= packed::lvalueReference;
+            type = type->element;
+        } else if (type->kind == TypeKind::rvalueReference) {
+            packed |= packed::rvalueReference;
+            type = type->element;
+        }
+
+        std::size_t count = 0;
+        bool array = false;
+        for (; type->kind == TypeKind::pointer || type->kind == TypeKind::array; type = type->element) {
+            if (count == packed::maxLayers) {
+                return packed::none;
+            }
+            PackedType layer = 0;
+            if (type->kind == TypeKind::array) {
+                if (array || type->bound > packed::maxBound) {
+                    return packed::none;
+                }
+                array = true;
+                layer = 1;
+                packed |= PackedType(type->bound) << packed::boundShift;
+            } else {
+                layer = PackedType(type->cv) << 1;
+            }
+            packed |= layer << (packed::layerShift + packed::layerBits * count);
+            ++count;
+        }
+        packed |= PackedType(count) << packed::countShift;
+
+        const Type* base = type;
+        if (type->kind == TypeKind::named) {
+            packed |= PackedType(type->cv) << packed::baseCvShift;
+            base = _types.withoutCv(type);
+        } else if (type->kind == TypeKind::function) {
+            packed |= packed::functionBase;
+        } else {
+            return packed::none;
+        }
+
+        auto const found = _baseIds.find(base);
+        if (found != _baseIds.end()) {
+            return packed | found->second;
+        }
+        if (_bases.size() > packed::baseMask) {
+            return packed::none;
+        }
+        PackedType const id = _bases.size();
+        _bases.push_back(base);
+        _baseIds.emplace(base, id);
+        return packed | id;
+    }
+
+    const Type* PackedTypeCodec::decode(PackedType packed) {
+        const Type* type = _bases[packed & packed::baseMask];
+        if (!(packed & packed::functionBase)) {
+            type = _types.withCv(type, static_cast<unsigned char>((packed >> packed::baseCvShift) & cvConstVolatile));
+        }
+
+        std::size_t const count = (packed & packed::countMask) >> packed::countShift;
+        for (std::size_t i = count; i-- > 0;) {
+            PackedType const layer = (packed >> (packed::layerShift + packed::layerBits * i)) & 0xf;
+            if (layer & 1) {
+                type = _types.arrayOf(type, (packed & packed::boundMask) >> packed::boundShift);
+            } else {
+                type = _types.pointerTo(type, static_cast<unsigned char>(layer >> 1));
+            }
+        }
+
+        switch (packed & packed::referenceMask) {
+        case packed::lvalueReference:
+            return _types.lvalueReferenceTo(type);
+        case packed::rvalueReference:
+            return _types.rvalueReferenceTo(type);
+        default:
+            return type;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include "packed_type.hpp"
+#include "type_model.hpp"
+
+namespace ttd {
+    // Converts between model types and packed words. Base ids are handed out
+    // in order of first use and stay valid for the codec's lifetime.
+    class PackedTypeCodec {
+    public:
+        explicit PackedTypeCodec(TypeTable& types) : _types(types) { }
+
+        PackedTypeCodec(const PackedTypeCodec&) = delete;
+        PackedTypeCodec& operator=(const PackedTypeCodec&) = delete;
+
+        // Returns packed::none if type does not fit. Both directions remember
+        // their answers, so a type seen before costs one hash lookup instead
+        // of a walk that interns every layer again.
+        PackedType pack(const Type* type);
+
+        // type must come from pack() on this codec, or be a deduction result
+        // computed from one; packed::none gives null.
+        const Type* unpack(PackedType type);
+
+        std::size_t baseCount() const {
+            return _bases.size();
+        }
+
+    private:
+        PackedType encode(const Type* type);
+        const Type* decode(PackedType type);
+
+        TypeTable& _types;
+        std::vector<const Type*> _bases;
+        std::unordered_map<const Type*, PackedType> _baseIds;
+        std::unordered_map<const Type*, PackedType> _packed;
+        std::unordered_map<PackedType, const Type*> _unpacked;
+    };
+}
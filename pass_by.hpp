@@ -0,0 +1,88 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "demangled_type_name.hpp"
+#include "output_sink.hpp"
+#include "report_stats.hpp"
+#include "scrub_type_name.hpp"
+#include "type_name.hpp"
+
+// The name backends of the report and the output of TemplateTypeInfos, on top
+// of the passBy* forms in ttd.hpp.
+//
+// Define ENABLE_BOOST and ENABLE_CONSTEXPR_TYPE_NAME (or not) before
+// including this header; main.cpp has the switches. A TU that includes both
+// this header and ttd.hpp must include this one first.
+
+#define TTD_EXTERNAL_TYPE_NAME
+#include "ttd.hpp"
+
+#ifdef ENABLE_BOOST
+#include <boost/type_index.hpp>
+#endif
+
+// Comment out ENABLE_CONSTEXPR_TYPE_NAME to get the names from boost instead,
+// which is handy for diffing the two backends. Without ENABLE_BOOST either,
+// they come from typeid and the native demangler, with the same spelling as
+// boost's and no boost in the build.
+//
+// Either way a name is computed once per type and lives in static storage, so
+// asking again for the same type is just a load.
+#ifdef ENABLE_CONSTEXPR_TYPE_NAME
+template <typename T>
+std::string_view typeName() {
+    TTD_STATS_SCOPE(names);
+    return ttd::constexprTypeName<T>();
+}
+#else
+#ifdef ENABLE_BOOST
+namespace ttd {
+    // Demangling, scrubbing and interning, shared by every T: typeName<T>
+    // only contributes its type_index.
+    TTD_NOINLINE inline std::string_view internPrettyName(const boost::typeindex::type_index& type) {
+        std::string name = type.pretty_name();
+        {
+            TTD_STATS_SCOPE(scrub);
+            name.resize(ttd::scrubTypeName(&name[0], name.size()));
+        }
+        return ttd::internTypeName(name);
+    }
+}
+
+template <typename T>
+std::string_view scrubbedPrettyName() {
+    return ttd::internPrettyName(boost::typeindex::type_id_with_cvr<T>());
+}
+#else
+template <typename T>
+std::string_view scrubbedPrettyName() {
+    return ttd::internTypeName(ttd::demangledTypeName<T>());
+}
+#endif
+
+template <typename T>
+std::string_view typeName() {
+    // Initialized on first use; concurrent first calls are serialized by the
+    // compiler, later calls only check the guard.
+    TTD_STATS_SCOPE(names);
+    static const std::string_view name = scrubbedPrettyName<T>();
+    return name;
+}
+#endif
+
+inline std::ostream& operator<<(std::ostream& os, const TemplateTypeInfos& infos) {
+    TTD_STATS_SCOPE(format);
+    os << "  + param type: " << infos.param << '\n';
+    os << "  + T:          " << infos.T << '\n';
+    return os;
+}
+
+inline ttd::OutputSink& operator<<(ttd::OutputSink& out, const TemplateTypeInfos& infos) {
+    TTD_STATS_SCOPE(format);
+    out << "  + param type: " << infos.param << '\n';
+    out << "  + T:          " << infos.T << '\n';
+    return out;
+}
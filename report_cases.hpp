@@ -0,0 +1,527 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "type_matrix.hpp"
+
+// The argument kinds of the deduction report. Every line is one variable, as
+// it is named and as it is moved; the matrix tries each of them with every
+// passBy* form.
+//
+// Known compiler divergences:
+//   - std::move(f), std::move(fr) and std::move(frr) with T&&: a function
+//     xvalue is an lvalue, so Param and T are void(&)(). MSVC is wrong here
+//     (see screenshot/msvc_bug.png).
+// compiler-matrix runs these cases under every installed compiler and
+// standard mode and lists where they disagree.
+
+namespace ttd {
+    using ReportArguments = TypeList<
+        Named<int, "a">, Moved<int, "a">,                                              // int a
+        Named<int*, "pa">, Moved<int*, "pa">,                                          // int* pa
+        Named<int&, "ra">, Moved<int&, "ra">,                                          // int& ra
+        Named<int&&, "rra">, Moved<int&&, "rra">,                                      // int&& rra
+
+        Named<int const, "ca">, Moved<int const, "ca">,                                // int const ca
+        Named<int const*, "cpa">, Moved<int const*, "cpa">,                            // int const* cpa
+        Named<int const* const, "pca">, Moved<int const* const, "pca">,                // int const* const pca
+        Named<int const&, "cra">, Moved<int const&, "cra">,                            // int const& cra
+        Named<int const&&, "crra">, Moved<int const&&, "crra">,                        // int const&& crra
+
+        Named<int[2], "as">, Moved<int[2], "as">,                                      // int as[2]
+        Named<int const[2], "cas">, Moved<int const[2], "cas">,                        // int const cas[2]
+        Named<int(*)[2], "pas">, Moved<int(*)[2], "pas">,                              // int(*pas)[2]
+        Named<int(* const)[2], "pcas">, Moved<int(* const)[2], "pcas">,                // int(* const pcas)[2]
+        Named<int const(*)[2], "cpas">, Moved<int const(*)[2], "cpas">,                // int const(*cpas)[2]
+        Named<int const(* const)[2], "cpcas">, Moved<int const(* const)[2], "cpcas">,  // int const(* const cpcas)[2]
+        Named<int(&)[2], "ras">, Moved<int(&)[2], "ras">,                              // int(&ras)[2]
+        Named<int const(&)[2], "cras">, Moved<int const(&)[2], "cras">,                // int const(&cras)[2]
+        Named<int(&&)[2], "rras">, Moved<int(&&)[2], "rras">,                          // int(&& rras)[2]
+        Named<int const(&&)[2], "crras">, Moved<int const(&&)[2], "crras">,            // int const(&& crras)[2]
+
+        Named<void(), "f">, Moved<void(), "f">,                                        // void f()
+        Named<void(*)(), "fp">, Moved<void(*)(), "fp">,                                // void (*fp)()
+        Named<void(* const)(), "fcp">, Moved<void(* const)(), "fcp">,                  // void (* const fcp)()
+        Named<void(&)(), "fr">, Moved<void(&)(), "fr">,                                // void(&fr)()
+        Named<void(&&)(), "frr">, Moved<void(&&)(), "frr">                             // void(&& frr)()
+    >;
+
+    using ReportMatrix = TypeMatrix<ReportArguments, DeductionForms>;
+
+    // The same arguments in auto, decltype(auto), generic lambda, structured
+    // binding and CTAD declarations.
+    using ContextMatrix = TypeMatrix<ReportArguments, ContextForms>;
+
+    // The passBy* templates as written, with bodies. The return type is
+    // deduced, so naming the type of a call instantiates the body, and the
+    // result is read from inside the instantiation: decltype(param) and T.
+    // The report itself reads the declared probes in deduction_probe.hpp;
+    // the expectations below hold both to the same answers.
+    namespace instantiated {
+        template <typename T>
+        auto passByValue([[maybe_unused]] T param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByRef([[maybe_unused]] T& param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByURef([[maybe_unused]] T&& param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByPtr([[maybe_unused]] T* param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByCPtr([[maybe_unused]] T const* param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByCRef([[maybe_unused]] T const& param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        template <typename T>
+        auto passByCRRef([[maybe_unused]] T const&& param) {
+            return Deduction<decltype(param), T>{};
+        }
+
+        // A form whose deduce<Arg> calls the instantiated template.
+        template <typename Form>
+        struct Of;
+
+#define TTD_INSTANTIATED_FORM(Form, function) \
+        template <> \
+        struct Of<form::Form> { \
+            template <typename Arg> \
+            using deduce = decltype(function(std::declval<typename Arg::expr>())); \
+        };
+
+        TTD_INSTANTIATED_FORM(PassByValue, passByValue)
+        TTD_INSTANTIATED_FORM(PassByRef, passByRef)
+        TTD_INSTANTIATED_FORM(PassByURef, passByURef)
+        TTD_INSTANTIATED_FORM(PassByPtr, passByPtr)
+        TTD_INSTANTIATED_FORM(PassByCPtr, passByCPtr)
+        TTD_INSTANTIATED_FORM(PassByCRef, passByCRef)
+        TTD_INSTANTIATED_FORM(PassByCRRef, passByCRRef)
+#undef TTD_INSTANTIATED_FORM
+    }
+
+    // One expected row of the report: Arg deduces Param and T, or does not
+    // deduce at all.
+    template <typename Arg, typename Param, typename T>
+    struct Deduces { };
+
+    template <typename Arg>
+    struct NoDeduction { };
+
+    namespace detail {
+        template <typename Row>
+        struct RowArgument;
+
+        template <typename Arg, typename Param, typename T>
+        struct RowArgument<Deduces<Arg, Param, T>> {
+            using type = Arg;
+        };
+
+        template <typename Arg>
+        struct RowArgument<NoDeduction<Arg>> {
+            using type = Arg;
+        };
+
+        template <typename Form, typename Row>
+        struct CheckRow;
+
+        template <typename Form, typename Arg, typename Param, typename T>
+        struct CheckRow<Form, Deduces<Arg, Param, T>> {
+            static_assert(Deducible<Form, Arg>, "the report finds no deduction where one is expected");
+            static_assert(Deducible<instantiated::Of<Form>, Arg>, "the template does not deduce where it is expected to");
+            static_assert(std::is_same_v<typename Form::template deduce<Arg>, Deduction<Param, T>>,
+                          "the report deduces other types than expected");
+            static_assert(std::is_same_v<typename instantiated::Of<Form>::template deduce<Arg>, Deduction<Param, T>>,
+                          "the template deduces other types than expected");
+        };
+
+        template <typename Form, typename Arg>
+        struct CheckRow<Form, NoDeduction<Arg>> {
+            static_assert(!Deducible<Form, Arg>, "the report finds a deduction where none is expected");
+            static_assert(!Deducible<instantiated::Of<Form>, Arg>, "the template deduces where it is expected not to");
+        };
+    }
+
+    // Every case of one form, in report order; the build fails on the first
+    // row the report or the template disagrees with.
+    template <typename Form, typename... Rows>
+    struct Expectations {
+        static_assert(std::is_same_v<TypeList<typename detail::RowArgument<Rows>::type...>, ReportArguments>,
+                      "the expectations must list every report argument in order");
+        static constexpr bool hold = (sizeof(detail::CheckRow<Form, Rows>) + ... + 0) > 0;
+    };
+
+    // What the report prints, per form and argument. compiler-matrix checks
+    // the same cases against other compilers.
+    static_assert(Expectations<form::PassByValue,
+        Deduces<Named<int, "a">, int, int>,
+        Deduces<Moved<int, "a">, int, int>,
+        Deduces<Named<int*, "pa">, int*, int*>,
+        Deduces<Moved<int*, "pa">, int*, int*>,
+        Deduces<Named<int&, "ra">, int, int>,
+        Deduces<Moved<int&, "ra">, int, int>,
+        Deduces<Named<int&&, "rra">, int, int>,
+        Deduces<Moved<int&&, "rra">, int, int>,
+        Deduces<Named<int const, "ca">, int, int>,
+        Deduces<Moved<int const, "ca">, int, int>,
+        Deduces<Named<int const*, "cpa">, int const*, int const*>,
+        Deduces<Moved<int const*, "cpa">, int const*, int const*>,
+        Deduces<Named<int const* const, "pca">, int const*, int const*>,
+        Deduces<Moved<int const* const, "pca">, int const*, int const*>,
+        Deduces<Named<int const&, "cra">, int, int>,
+        Deduces<Moved<int const&, "cra">, int, int>,
+        Deduces<Named<int const&&, "crra">, int, int>,
+        Deduces<Moved<int const&&, "crra">, int, int>,
+        Deduces<Named<int[2], "as">, int*, int*>,
+        Deduces<Moved<int[2], "as">, int*, int*>,
+        Deduces<Named<int const[2], "cas">, int const*, int const*>,
+        Deduces<Moved<int const[2], "cas">, int const*, int const*>,
+        Deduces<Named<int(*)[2], "pas">, int(*)[2], int(*)[2]>,
+        Deduces<Moved<int(*)[2], "pas">, int(*)[2], int(*)[2]>,
+        Deduces<Named<int(* const)[2], "pcas">, int(*)[2], int(*)[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(*)[2], int(*)[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(*)[2], int const(*)[2]>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(*)[2], int const(*)[2]>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(*)[2], int const(*)[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(*)[2], int const(*)[2]>,
+        Deduces<Named<int(&)[2], "ras">, int*, int*>,
+        Deduces<Moved<int(&)[2], "ras">, int*, int*>,
+        Deduces<Named<int const(&)[2], "cras">, int const*, int const*>,
+        Deduces<Moved<int const(&)[2], "cras">, int const*, int const*>,
+        Deduces<Named<int(&&)[2], "rras">, int*, int*>,
+        Deduces<Moved<int(&&)[2], "rras">, int*, int*>,
+        Deduces<Named<int const(&&)[2], "crras">, int const*, int const*>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const*, int const*>,
+        Deduces<Named<void(), "f">, void(*)(), void(*)()>,
+        Deduces<Moved<void(), "f">, void(*)(), void(*)()>,
+        Deduces<Named<void(*)(), "fp">, void(*)(), void(*)()>,
+        Deduces<Moved<void(*)(), "fp">, void(*)(), void(*)()>,
+        Deduces<Named<void(* const)(), "fcp">, void(*)(), void(*)()>,
+        Deduces<Moved<void(* const)(), "fcp">, void(*)(), void(*)()>,
+        Deduces<Named<void(&)(), "fr">, void(*)(), void(*)()>,
+        Deduces<Moved<void(&)(), "fr">, void(*)(), void(*)()>,
+        Deduces<Named<void(&&)(), "frr">, void(*)(), void(*)()>,
+        Deduces<Moved<void(&&)(), "frr">, void(*)(), void(*)()>
+    >::hold);
+
+    static_assert(Expectations<form::PassByRef,
+        Deduces<Named<int, "a">, int&, int>,
+        NoDeduction<Moved<int, "a">>,
+        Deduces<Named<int*, "pa">, int*&, int*>,
+        NoDeduction<Moved<int*, "pa">>,
+        Deduces<Named<int&, "ra">, int&, int>,
+        NoDeduction<Moved<int&, "ra">>,
+        Deduces<Named<int&&, "rra">, int&, int>,
+        NoDeduction<Moved<int&&, "rra">>,
+        Deduces<Named<int const, "ca">, int const&, int const>,
+        Deduces<Moved<int const, "ca">, int const&, int const>,
+        Deduces<Named<int const*, "cpa">, int const*&, int const*>,
+        NoDeduction<Moved<int const*, "cpa">>,
+        Deduces<Named<int const* const, "pca">, int const* const&, int const* const>,
+        Deduces<Moved<int const* const, "pca">, int const* const&, int const* const>,
+        Deduces<Named<int const&, "cra">, int const&, int const>,
+        Deduces<Moved<int const&, "cra">, int const&, int const>,
+        Deduces<Named<int const&&, "crra">, int const&, int const>,
+        Deduces<Moved<int const&&, "crra">, int const&, int const>,
+        Deduces<Named<int[2], "as">, int(&)[2], int[2]>,
+        NoDeduction<Moved<int[2], "as">>,
+        Deduces<Named<int const[2], "cas">, int const(&)[2], int const[2]>,
+        Deduces<Moved<int const[2], "cas">, int const(&)[2], int const[2]>,
+        Deduces<Named<int(*)[2], "pas">, int(*&)[2], int(*)[2]>,
+        NoDeduction<Moved<int(*)[2], "pas">>,
+        Deduces<Named<int(* const)[2], "pcas">, int(* const&)[2], int(* const)[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(* const&)[2], int(* const)[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(*&)[2], int const(*)[2]>,
+        NoDeduction<Moved<int const(*)[2], "cpas">>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(* const&)[2], int const(* const)[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(* const&)[2], int const(* const)[2]>,
+        Deduces<Named<int(&)[2], "ras">, int(&)[2], int[2]>,
+        NoDeduction<Moved<int(&)[2], "ras">>,
+        Deduces<Named<int const(&)[2], "cras">, int const(&)[2], int const[2]>,
+        Deduces<Moved<int const(&)[2], "cras">, int const(&)[2], int const[2]>,
+        Deduces<Named<int(&&)[2], "rras">, int(&)[2], int[2]>,
+        NoDeduction<Moved<int(&&)[2], "rras">>,
+        Deduces<Named<int const(&&)[2], "crras">, int const(&)[2], int const[2]>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const(&)[2], int const[2]>,
+        Deduces<Named<void(), "f">, void(&)(), void()>,
+        Deduces<Moved<void(), "f">, void(&)(), void()>,
+        Deduces<Named<void(*)(), "fp">, void(*&)(), void(*)()>,
+        NoDeduction<Moved<void(*)(), "fp">>,
+        Deduces<Named<void(* const)(), "fcp">, void(* const&)(), void(* const)()>,
+        Deduces<Moved<void(* const)(), "fcp">, void(* const&)(), void(* const)()>,
+        Deduces<Named<void(&)(), "fr">, void(&)(), void()>,
+        Deduces<Moved<void(&)(), "fr">, void(&)(), void()>,
+        Deduces<Named<void(&&)(), "frr">, void(&)(), void()>,
+        Deduces<Moved<void(&&)(), "frr">, void(&)(), void()>
+    >::hold);
+
+    static_assert(Expectations<form::PassByURef,
+        Deduces<Named<int, "a">, int&, int&>,
+        Deduces<Moved<int, "a">, int&&, int>,
+        Deduces<Named<int*, "pa">, int*&, int*&>,
+        Deduces<Moved<int*, "pa">, int*&&, int*>,
+        Deduces<Named<int&, "ra">, int&, int&>,
+        Deduces<Moved<int&, "ra">, int&&, int>,
+        Deduces<Named<int&&, "rra">, int&, int&>,
+        Deduces<Moved<int&&, "rra">, int&&, int>,
+        Deduces<Named<int const, "ca">, int const&, int const&>,
+        Deduces<Moved<int const, "ca">, int const&&, int const>,
+        Deduces<Named<int const*, "cpa">, int const*&, int const*&>,
+        Deduces<Moved<int const*, "cpa">, int const*&&, int const*>,
+        Deduces<Named<int const* const, "pca">, int const* const&, int const* const&>,
+        Deduces<Moved<int const* const, "pca">, int const* const&&, int const* const>,
+        Deduces<Named<int const&, "cra">, int const&, int const&>,
+        Deduces<Moved<int const&, "cra">, int const&&, int const>,
+        Deduces<Named<int const&&, "crra">, int const&, int const&>,
+        Deduces<Moved<int const&&, "crra">, int const&&, int const>,
+        Deduces<Named<int[2], "as">, int(&)[2], int(&)[2]>,
+        Deduces<Moved<int[2], "as">, int(&&)[2], int[2]>,
+        Deduces<Named<int const[2], "cas">, int const(&)[2], int const(&)[2]>,
+        Deduces<Moved<int const[2], "cas">, int const(&&)[2], int const[2]>,
+        Deduces<Named<int(*)[2], "pas">, int(*&)[2], int(*&)[2]>,
+        Deduces<Moved<int(*)[2], "pas">, int(*&&)[2], int(*)[2]>,
+        Deduces<Named<int(* const)[2], "pcas">, int(* const&)[2], int(* const&)[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(* const&&)[2], int(* const)[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(*&)[2], int const(*&)[2]>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(*&&)[2], int const(*)[2]>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(* const&)[2], int const(* const&)[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(* const&&)[2], int const(* const)[2]>,
+        Deduces<Named<int(&)[2], "ras">, int(&)[2], int(&)[2]>,
+        Deduces<Moved<int(&)[2], "ras">, int(&&)[2], int[2]>,
+        Deduces<Named<int const(&)[2], "cras">, int const(&)[2], int const(&)[2]>,
+        Deduces<Moved<int const(&)[2], "cras">, int const(&&)[2], int const[2]>,
+        Deduces<Named<int(&&)[2], "rras">, int(&)[2], int(&)[2]>,
+        Deduces<Moved<int(&&)[2], "rras">, int(&&)[2], int[2]>,
+        Deduces<Named<int const(&&)[2], "crras">, int const(&)[2], int const(&)[2]>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const(&&)[2], int const[2]>,
+        Deduces<Named<void(), "f">, void(&)(), void(&)()>,
+        Deduces<Moved<void(), "f">, void(&)(), void(&)()>,  // an lvalue, MSVC is wrong
+        Deduces<Named<void(*)(), "fp">, void(*&)(), void(*&)()>,
+        Deduces<Moved<void(*)(), "fp">, void(*&&)(), void(*)()>,
+        Deduces<Named<void(* const)(), "fcp">, void(* const&)(), void(* const&)()>,
+        Deduces<Moved<void(* const)(), "fcp">, void(* const&&)(), void(* const)()>,
+        Deduces<Named<void(&)(), "fr">, void(&)(), void(&)()>,
+        Deduces<Moved<void(&)(), "fr">, void(&)(), void(&)()>,  // an lvalue, MSVC is wrong
+        Deduces<Named<void(&&)(), "frr">, void(&)(), void(&)()>,
+        Deduces<Moved<void(&&)(), "frr">, void(&)(), void(&)()>  // an lvalue, MSVC is wrong
+    >::hold);
+
+    static_assert(Expectations<form::PassByPtr,
+        NoDeduction<Named<int, "a">>,
+        NoDeduction<Moved<int, "a">>,
+        Deduces<Named<int*, "pa">, int*, int>,
+        Deduces<Moved<int*, "pa">, int*, int>,
+        NoDeduction<Named<int&, "ra">>,
+        NoDeduction<Moved<int&, "ra">>,
+        NoDeduction<Named<int&&, "rra">>,
+        NoDeduction<Moved<int&&, "rra">>,
+        NoDeduction<Named<int const, "ca">>,
+        NoDeduction<Moved<int const, "ca">>,
+        Deduces<Named<int const*, "cpa">, int const*, int const>,
+        Deduces<Moved<int const*, "cpa">, int const*, int const>,
+        Deduces<Named<int const* const, "pca">, int const*, int const>,
+        Deduces<Moved<int const* const, "pca">, int const*, int const>,
+        NoDeduction<Named<int const&, "cra">>,
+        NoDeduction<Moved<int const&, "cra">>,
+        NoDeduction<Named<int const&&, "crra">>,
+        NoDeduction<Moved<int const&&, "crra">>,
+        Deduces<Named<int[2], "as">, int*, int>,
+        Deduces<Moved<int[2], "as">, int*, int>,
+        Deduces<Named<int const[2], "cas">, int const*, int const>,
+        Deduces<Moved<int const[2], "cas">, int const*, int const>,
+        Deduces<Named<int(*)[2], "pas">, int(*)[2], int[2]>,
+        Deduces<Moved<int(*)[2], "pas">, int(*)[2], int[2]>,
+        Deduces<Named<int(* const)[2], "pcas">, int(*)[2], int[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(*)[2], int[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(*)[2], int const[2]>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(*)[2], int const[2]>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(*)[2], int const[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(*)[2], int const[2]>,
+        Deduces<Named<int(&)[2], "ras">, int*, int>,
+        Deduces<Moved<int(&)[2], "ras">, int*, int>,
+        Deduces<Named<int const(&)[2], "cras">, int const*, int const>,
+        Deduces<Moved<int const(&)[2], "cras">, int const*, int const>,
+        Deduces<Named<int(&&)[2], "rras">, int*, int>,
+        Deduces<Moved<int(&&)[2], "rras">, int*, int>,
+        Deduces<Named<int const(&&)[2], "crras">, int const*, int const>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const*, int const>,
+        Deduces<Named<void(), "f">, void(*)(), void()>,
+        Deduces<Moved<void(), "f">, void(*)(), void()>,
+        Deduces<Named<void(*)(), "fp">, void(*)(), void()>,
+        Deduces<Moved<void(*)(), "fp">, void(*)(), void()>,
+        Deduces<Named<void(* const)(), "fcp">, void(*)(), void()>,
+        Deduces<Moved<void(* const)(), "fcp">, void(*)(), void()>,
+        Deduces<Named<void(&)(), "fr">, void(*)(), void()>,
+        Deduces<Moved<void(&)(), "fr">, void(*)(), void()>,
+        Deduces<Named<void(&&)(), "frr">, void(*)(), void()>,
+        Deduces<Moved<void(&&)(), "frr">, void(*)(), void()>
+    >::hold);
+
+    static_assert(Expectations<form::PassByCPtr,
+        NoDeduction<Named<int, "a">>,
+        NoDeduction<Moved<int, "a">>,
+        Deduces<Named<int*, "pa">, int const*, int>,
+        Deduces<Moved<int*, "pa">, int const*, int>,
+        NoDeduction<Named<int&, "ra">>,
+        NoDeduction<Moved<int&, "ra">>,
+        NoDeduction<Named<int&&, "rra">>,
+        NoDeduction<Moved<int&&, "rra">>,
+        NoDeduction<Named<int const, "ca">>,
+        NoDeduction<Moved<int const, "ca">>,
+        Deduces<Named<int const*, "cpa">, int const*, int>,
+        Deduces<Moved<int const*, "cpa">, int const*, int>,
+        Deduces<Named<int const* const, "pca">, int const*, int>,
+        Deduces<Moved<int const* const, "pca">, int const*, int>,
+        NoDeduction<Named<int const&, "cra">>,
+        NoDeduction<Moved<int const&, "cra">>,
+        NoDeduction<Named<int const&&, "crra">>,
+        NoDeduction<Moved<int const&&, "crra">>,
+        Deduces<Named<int[2], "as">, int const*, int>,
+        Deduces<Moved<int[2], "as">, int const*, int>,
+        Deduces<Named<int const[2], "cas">, int const*, int>,
+        Deduces<Moved<int const[2], "cas">, int const*, int>,
+        Deduces<Named<int(*)[2], "pas">, int const(*)[2], int[2]>,
+        Deduces<Moved<int(*)[2], "pas">, int const(*)[2], int[2]>,
+        Deduces<Named<int(* const)[2], "pcas">, int const(*)[2], int[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int const(*)[2], int[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(*)[2], int[2]>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(*)[2], int[2]>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(*)[2], int[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(*)[2], int[2]>,
+        Deduces<Named<int(&)[2], "ras">, int const*, int>,
+        Deduces<Moved<int(&)[2], "ras">, int const*, int>,
+        Deduces<Named<int const(&)[2], "cras">, int const*, int>,
+        Deduces<Moved<int const(&)[2], "cras">, int const*, int>,
+        Deduces<Named<int(&&)[2], "rras">, int const*, int>,
+        Deduces<Moved<int(&&)[2], "rras">, int const*, int>,
+        Deduces<Named<int const(&&)[2], "crras">, int const*, int>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const*, int>,
+        NoDeduction<Named<void(), "f">>,
+        NoDeduction<Moved<void(), "f">>,
+        NoDeduction<Named<void(*)(), "fp">>,
+        NoDeduction<Moved<void(*)(), "fp">>,
+        NoDeduction<Named<void(* const)(), "fcp">>,
+        NoDeduction<Moved<void(* const)(), "fcp">>,
+        NoDeduction<Named<void(&)(), "fr">>,
+        NoDeduction<Moved<void(&)(), "fr">>,
+        NoDeduction<Named<void(&&)(), "frr">>,
+        NoDeduction<Moved<void(&&)(), "frr">>
+    >::hold);
+
+    static_assert(Expectations<form::PassByCRef,
+        Deduces<Named<int, "a">, int const&, int>,
+        Deduces<Moved<int, "a">, int const&, int>,
+        Deduces<Named<int*, "pa">, int* const&, int*>,
+        Deduces<Moved<int*, "pa">, int* const&, int*>,
+        Deduces<Named<int&, "ra">, int const&, int>,
+        Deduces<Moved<int&, "ra">, int const&, int>,
+        Deduces<Named<int&&, "rra">, int const&, int>,
+        Deduces<Moved<int&&, "rra">, int const&, int>,
+        Deduces<Named<int const, "ca">, int const&, int>,
+        Deduces<Moved<int const, "ca">, int const&, int>,
+        Deduces<Named<int const*, "cpa">, int const* const&, int const*>,
+        Deduces<Moved<int const*, "cpa">, int const* const&, int const*>,
+        Deduces<Named<int const* const, "pca">, int const* const&, int const*>,
+        Deduces<Moved<int const* const, "pca">, int const* const&, int const*>,
+        Deduces<Named<int const&, "cra">, int const&, int>,
+        Deduces<Moved<int const&, "cra">, int const&, int>,
+        Deduces<Named<int const&&, "crra">, int const&, int>,
+        Deduces<Moved<int const&&, "crra">, int const&, int>,
+        Deduces<Named<int[2], "as">, int const(&)[2], int[2]>,
+        Deduces<Moved<int[2], "as">, int const(&)[2], int[2]>,
+        Deduces<Named<int const[2], "cas">, int const(&)[2], int[2]>,
+        Deduces<Moved<int const[2], "cas">, int const(&)[2], int[2]>,
+        Deduces<Named<int(*)[2], "pas">, int(* const&)[2], int(*)[2]>,
+        Deduces<Moved<int(*)[2], "pas">, int(* const&)[2], int(*)[2]>,
+        Deduces<Named<int(* const)[2], "pcas">, int(* const&)[2], int(*)[2]>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(* const&)[2], int(*)[2]>,
+        Deduces<Named<int const(*)[2], "cpas">, int const(* const&)[2], int const(*)[2]>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(* const&)[2], int const(*)[2]>,
+        Deduces<Named<int const(* const)[2], "cpcas">, int const(* const&)[2], int const(*)[2]>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(* const&)[2], int const(*)[2]>,
+        Deduces<Named<int(&)[2], "ras">, int const(&)[2], int[2]>,
+        Deduces<Moved<int(&)[2], "ras">, int const(&)[2], int[2]>,
+        Deduces<Named<int const(&)[2], "cras">, int const(&)[2], int[2]>,
+        Deduces<Moved<int const(&)[2], "cras">, int const(&)[2], int[2]>,
+        Deduces<Named<int(&&)[2], "rras">, int const(&)[2], int[2]>,
+        Deduces<Moved<int(&&)[2], "rras">, int const(&)[2], int[2]>,
+        Deduces<Named<int const(&&)[2], "crras">, int const(&)[2], int[2]>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const(&)[2], int[2]>,
+        Deduces<Named<void(), "f">, void(&)(), void()>,
+        Deduces<Moved<void(), "f">, void(&)(), void()>,
+        Deduces<Named<void(*)(), "fp">, void(* const&)(), void(*)()>,
+        Deduces<Moved<void(*)(), "fp">, void(* const&)(), void(*)()>,
+        Deduces<Named<void(* const)(), "fcp">, void(* const&)(), void(*)()>,
+        Deduces<Moved<void(* const)(), "fcp">, void(* const&)(), void(*)()>,
+        Deduces<Named<void(&)(), "fr">, void(&)(), void()>,
+        Deduces<Moved<void(&)(), "fr">, void(&)(), void()>,
+        Deduces<Named<void(&&)(), "frr">, void(&)(), void()>,
+        Deduces<Moved<void(&&)(), "frr">, void(&)(), void()>
+    >::hold);
+
+    static_assert(Expectations<form::PassByCRRef,
+        NoDeduction<Named<int, "a">>,
+        Deduces<Moved<int, "a">, int const&&, int>,
+        NoDeduction<Named<int*, "pa">>,
+        Deduces<Moved<int*, "pa">, int* const&&, int*>,
+        NoDeduction<Named<int&, "ra">>,
+        Deduces<Moved<int&, "ra">, int const&&, int>,
+        NoDeduction<Named<int&&, "rra">>,
+        Deduces<Moved<int&&, "rra">, int const&&, int>,
+        NoDeduction<Named<int const, "ca">>,
+        Deduces<Moved<int const, "ca">, int const&&, int>,
+        NoDeduction<Named<int const*, "cpa">>,
+        Deduces<Moved<int const*, "cpa">, int const* const&&, int const*>,
+        NoDeduction<Named<int const* const, "pca">>,
+        Deduces<Moved<int const* const, "pca">, int const* const&&, int const*>,
+        NoDeduction<Named<int const&, "cra">>,
+        Deduces<Moved<int const&, "cra">, int const&&, int>,
+        NoDeduction<Named<int const&&, "crra">>,
+        Deduces<Moved<int const&&, "crra">, int const&&, int>,
+        NoDeduction<Named<int[2], "as">>,
+        Deduces<Moved<int[2], "as">, int const(&&)[2], int[2]>,
+        NoDeduction<Named<int const[2], "cas">>,
+        Deduces<Moved<int const[2], "cas">, int const(&&)[2], int[2]>,
+        NoDeduction<Named<int(*)[2], "pas">>,
+        Deduces<Moved<int(*)[2], "pas">, int(* const&&)[2], int(*)[2]>,
+        NoDeduction<Named<int(* const)[2], "pcas">>,
+        Deduces<Moved<int(* const)[2], "pcas">, int(* const&&)[2], int(*)[2]>,
+        NoDeduction<Named<int const(*)[2], "cpas">>,
+        Deduces<Moved<int const(*)[2], "cpas">, int const(* const&&)[2], int const(*)[2]>,
+        NoDeduction<Named<int const(* const)[2], "cpcas">>,
+        Deduces<Moved<int const(* const)[2], "cpcas">, int const(* const&&)[2], int const(*)[2]>,
+        NoDeduction<Named<int(&)[2], "ras">>,
+        Deduces<Moved<int(&)[2], "ras">, int const(&&)[2], int[2]>,
+        NoDeduction<Named<int const(&)[2], "cras">>,
+        Deduces<Moved<int const(&)[2], "cras">, int const(&&)[2], int[2]>,
+        NoDeduction<Named<int(&&)[2], "rras">>,
+        Deduces<Moved<int(&&)[2], "rras">, int const(&&)[2], int[2]>,
+        NoDeduction<Named<int const(&&)[2], "crras">>,
+        Deduces<Moved<int const(&&)[2], "crras">, int const(&&)[2], int[2]>,
+        Deduces<Named<void(), "f">, void(&&)(), void()>,
+        Deduces<Moved<void(), "f">, void(&&)(), void()>,
+        NoDeduction<Named<void(*)(), "fp">>,
+        Deduces<Moved<void(*)(), "fp">, void(* const&&)(), void(*)()>,
+        NoDeduction<Named<void(* const)(), "fcp">>,
+        Deduces<Moved<void(* const)(), "fcp">, void(* const&&)(), void(*)()>,
+        Deduces<Named<void(&)(), "fr">, void(&&)(), void()>,
+        Deduces<Moved<void(&)(), "fr">, void(&&)(), void()>,
+        Deduces<Named<void(&&)(), "frr">, void(&&)(), void()>,
+        Deduces<Moved<void(&&)(), "frr">, void(&&)(), void()>
+    >::hold);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "allocation_counter.hpp"
+
+// Where the report's time goes: name generation, name scrubbing and output
+// formatting.
+//
+// Code marks a phase with TTD_STATS_SCOPE(names), (scrub) or (format). Scopes
+// nest, and each phase gets only the time not spent in a nested one, so the
+// names inside a formatted case are not counted twice. The counters live in
+// the thread, so recording takes no lock; a thread records only after
+// enable(true).
+//
+// Without TTD_STATS the scopes compile to nothing. With it, a scope on a
+// thread that has not enabled recording costs one thread-local load. Bytes
+// allocated come from allocation_counter.cpp, and stay 0 unless it is linked.
+
+namespace ttd {
+    namespace stats {
+        enum class Phase : unsigned char {
+            names,
+            scrub,
+            format,
+        };
+
+        constexpr std::size_t phaseCount = 3;
+
+        constexpr std::string_view phaseNames[phaseCount] = { "names", "scrub", "format" };
+
+        struct Counters {
+            std::uint64_t ns[phaseCount] = {};
+            std::uint64_t calls[phaseCount] = {};
+            std::uint64_t bytes = 0;
+
+            Counters& operator+=(const Counters& other) {
+                for (std::size_t i = 0; i < phaseCount; ++i) {
+                    ns[i] += other.ns[i];
+                    calls[i] += other.calls[i];
+                }
+                bytes += other.bytes;
+                return *this;
+            }
+
+            Counters operator-(const Counters& other) const {
+                Counters difference;
+                for (std::size_t i = 0; i < phaseCount; ++i) {
+                    difference.ns[i] = ns[i] - other.ns[i];
+                    difference.calls[i] = calls[i] - other.calls[i];
+                }
+                difference.bytes = bytes - other.bytes;
+                return difference;
+            }
+
+            std::uint64_t totalNs() const {
+                std::uint64_t total = 0;
+                for (std::uint64_t phase : ns) {
+                    total += phase;
+                }
+                return total;
+            }
+        };
+
+        class Scope;
+
+        struct ThreadState {
+            bool enabled = false;
+            Counters counters;
+            Scope* open = nullptr;
+        };
+
+        inline thread_local ThreadState threadState;
+
+        inline void enable(bool on) {
+            threadState.enabled = on;
+        }
+
+        // This thread's counters so far; subtract two snapshots for an interval.
+        inline Counters snapshot() {
+            Counters counters = threadState.counters;
+            counters.bytes = threadAllocatedBytes;
+            return counters;
+        }
+
+        class Scope {
+        public:
+            explicit Scope(Phase phase) {
+                if (threadState.enabled) {
+                    _phase = phase;
+                    _parent = threadState.open;
+                    threadState.open = this;
+                    _active = true;
+                    _start = Clock::now();
+                }
+            }
+
+            ~Scope() {
+                if (_active) {
+                    std::uint64_t const elapsed = static_cast<std::uint64_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - _start).count());
+                    std::size_t const phase = static_cast<std::size_t>(_phase);
+                    threadState.counters.ns[phase] += elapsed > _nested ? elapsed - _nested : 0;
+                    ++threadState.counters.calls[phase];
+                    if (_parent != nullptr) {
+                        _parent->_nested += elapsed;
+                    }
+                    threadState.open = _parent;
+                }
+            }
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            Clock::time_point _start;
+            std::uint64_t _nested = 0;
+            Scope* _parent = nullptr;
+            Phase _phase = Phase::names;
+            bool _active = false;
+        };
+    }
+}
+
+#ifdef TTD_STATS
+#define TTD_STATS_SCOPE(phase) ::ttd::stats::Scope ttdStatsScope(::ttd::stats::Phase::phase)
+#else
+#define TTD_STATS_SCOPE(phase) static_cast<void>(0)
+#endif
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// Cleans up a type name as printed by a compiler or a demangler.
+//
+// The name is rewritten in place in a single left-to-right scan, nothing is
+// allocated. The scrubber
+//   - drops MSVC noise: __ptr64, __ptr32, calling conventions and the
+//     class/struct/union/enum keywords in front of class types,
+//   - collapses runs of blanks and trims both ends,
+//   - glues `*`, `&`, `(`, `)`, `[`, `]` and `,` to what precedes them,
+//   - puts one blank between `*`/`&` and a following `const`/`volatile`,
+//   - turns `(void)` into `()`.
+// So `int const * __ptr64 const &`, `int const *const &` and
+// `int const* const&` all come out as `int const* const&`.
+//
+// The output is never longer than the input. A blank can only be inserted
+// where one was removed before, so a name like `int*const` that has no
+// blanks at all keeps its spelling.
+
+namespace ttd {
+    namespace detail {
+        constexpr bool isScrubIdentifierChar(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        }
+
+        constexpr bool isScrubBlank(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        constexpr bool isScrubNoise(std::string_view word) {
+            return word == "__ptr64" || word == "__ptr32"
+                || word == "__cdecl" || word == "__stdcall" || word == "__fastcall"
+                || word == "__thiscall" || word == "__vectorcall" || word == "__clrcall"
+                || word == "class" || word == "struct" || word == "union" || word == "enum";
+        }
+
+        constexpr bool isScrubGlued(char c) {
+            return c == '*' || c == '&' || c == '(' || c == ')' || c == '[' || c == ']' || c == ',' || c == '<' || c == ':';
+        }
+    }
+
+    // Scrubs s[0, n) in place and returns the new length.
+    constexpr std::size_t scrubTypeName(char* s, std::size_t n) {
+        std::size_t w = 0;
+        std::size_t r = 0;
+        bool blank = false;
+
+        while (r < n) {
+            char const c = s[r];
+
+            if (detail::isScrubBlank(c)) {
+                blank = true;
+                ++r;
+                continue;
+            }
+
+            if (detail::isScrubIdentifierChar(c)) {
+                std::size_t end = r;
+                while (end < n && detail::isScrubIdentifierChar(s[end])) {
+                    ++end;
+                }
+
+                if (detail::isScrubNoise(std::string_view(s + r, end - r))) {
+                    blank = true;
+                    r = end;
+                    continue;
+                }
+
+                if (w > 0 && w < r) {
+                    char const prev = s[w - 1];
+                    bool const separate = detail::isScrubIdentifierChar(prev)
+                        || prev == '*' || prev == '&'
+                        || (blank && prev != '(' && prev != '<' && prev != '[' && prev != ':');
+                    if (separate) {
+                        s[w++] = ' ';
+                    }
+                }
+
+                while (r < end) {
+                    s[w++] = s[r++];
+                }
+                blank = false;
+                continue;
+            }
+
+            if (c == ')' && w >= 5 && std::string_view(s + w - 5, 5) == "(void") {
+                w -= 4;
+            } else if (w > 0 && blank && !detail::isScrubGlued(c) && s[w - 1] != '(' && s[w - 1] != '<') {
+                s[w++] = ' ';
+            }
+
+            s[w++] = c;
+            ++r;
+            blank = false;
+        }
+
+        return w;
+    }
+}
@@ -0,0 +1,45 @@
+// The deduction report, assembled entirely at compile time.
+//
+// The cases come from the same ReportMatrix and ContextMatrix as main.cpp,
+// but every name is spelled by the compiler, so the report is two constexpr
+// arrays in .rodata and running the program is two write()s. There is no
+// iostream, no demangling and no allocation.
+
+#include <array>
+#include <cstddef>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "report_cases.hpp"
+#include "static_report.hpp"
+
+namespace {
+    template <std::size_t N>
+    bool writeAll(const std::array<char, N>& text) {
+        const char* data = text.data();
+        std::size_t size = text.size();
+        while (size > 0) {
+#ifdef _WIN32
+            int const written = ::_write(1, data, static_cast<unsigned>(size));
+#else
+            auto const written = ::write(1, data, size);
+#endif
+            if (written <= 0) {
+                return false;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+}
+
+int main() {
+    bool const written = writeAll(ttd::StaticReport<ttd::ReportMatrix>::text)
+                         && writeAll(ttd::StaticReport<ttd::ContextMatrix>::text);
+    return written ? 0 : 1;
+}
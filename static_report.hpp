@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "type_matrix.hpp"
+#include "type_name.hpp"
+
+// Assembles the deduction report at compile time.
+//
+// A StaticRow is what the report prints for one case of a TypeMatrix, a
+// StaticSection is a form's banner followed by its rows, and
+// StaticReport<Matrix>::text is the whole report as one constexpr character
+// array.
+
+namespace ttd {
+    namespace detail {
+        template <std::size_t... Ns>
+        constexpr auto concatPieces(const std::array<std::string_view, Ns>&... arrays) {
+            std::array<std::string_view, (Ns + ... + 0)> result{};
+            std::size_t i = 0;
+            ((void)[&] {
+                for (std::string_view piece : arrays) {
+                    result[i++] = piece;
+                }
+            }(), ...);
+            return result;
+        }
+
+        template <std::size_t N>
+        constexpr std::size_t totalLength(const std::array<std::string_view, N>& pieces) {
+            std::size_t length = 0;
+            for (std::string_view piece : pieces) {
+                length += piece.size();
+            }
+            return length;
+        }
+
+        template <std::size_t Length, std::size_t N>
+        constexpr std::array<char, Length> joinPieces(const std::array<std::string_view, N>& pieces) {
+            std::array<char, Length> text{};
+            std::size_t i = 0;
+            for (std::string_view piece : pieces) {
+                for (char c : piece) {
+                    text[i++] = c;
+                }
+            }
+            return text;
+        }
+    }
+
+    template <typename Case, bool = Case::viable>
+    struct StaticRow {
+        static constexpr std::array<std::string_view, 10> pieces = {
+            constexprTypeName<typename Case::arg>(), "\n",
+            "  + expression: ", Case::expression, "\n",
+            "  + category:   ", valueCategoryName(Case::category), "\n",
+            "  + no viable deduction\n",
+            "\n",
+        };
+    };
+
+    template <typename Case>
+    struct StaticRow<Case, true> {
+        static constexpr std::array<std::string_view, 15> pieces = {
+            constexprTypeName<typename Case::arg>(), "\n",
+            "  + expression: ", Case::expression, "\n",
+            "  + category:   ", valueCategoryName(Case::category), "\n",
+            "  + param type: ", constexprTypeName<typename Case::param>(), "\n",
+            "  + T:          ", constexprTypeName<typename Case::type>(), "\n",
+            "\n",
+        };
+    };
+
+    template <typename Form, typename Cases>
+    struct StaticSection;
+
+    template <typename Form, typename... Cases>
+    struct StaticSection<Form, TypeList<Cases...>> {
+        static constexpr auto pieces = detail::concatPieces(std::array<std::string_view, 1>{ Form::banner }, StaticRow<Cases>::pieces...);
+    };
+
+    template <typename Matrix, typename Forms = typename Matrix::forms>
+    struct StaticReport;
+
+    template <typename Matrix, typename... Forms>
+    struct StaticReport<Matrix, TypeList<Forms...>> {
+        static constexpr auto pieces = detail::concatPieces(StaticSection<Forms, typename Matrix::template cases<Forms>>::pieces...);
+        static constexpr std::size_t size = detail::totalLength(pieces);
+        static constexpr std::array<char, size> text = detail::joinPieces<size>(pieces);
+    };
+}
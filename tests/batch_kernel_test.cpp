@@ -0,0 +1,142 @@
+// The batch deduction kernels against DeductionEngine.
+//
+// Every type of up to three pointer or array layers over a few bases, with
+// every cv and reference, is deduced as an lvalue, an xvalue and a prvalue in
+// every form: by each kernel the CPU supports on the packed types, and by the
+// model-type overload. The answers must be the engine's. Batches are an odd
+// size, so the SIMD kernels also leave a scalar tail.
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "../batch_deduction.hpp"
+#include "../type_parser.hpp"
+#include "../type_printer.hpp"
+
+namespace {
+    using namespace ttd;
+
+    std::size_t failures = 0;
+
+    const char* const kernelNames[] = { "scalar", "sse4.1", "avx2" };
+
+    constexpr unsigned char cvs[] = { cvNone, cvConst, cvVolatile, cvConstVolatile };
+
+    void addLayers(TypeTable& types, const Type* type, std::size_t layers, bool array, std::vector<const Type*>& out) {
+        out.push_back(type);
+        out.push_back(types.lvalueReferenceTo(type));
+        out.push_back(types.rvalueReferenceTo(type));
+        if (layers == 3) {
+            return;
+        }
+        for (unsigned char cv : cvs) {
+            addLayers(types, types.pointerTo(type, cv), layers + 1, array, out);
+        }
+        if (!array && type->kind != TypeKind::function) {
+            addLayers(types, types.arrayOf(type, layers == 0 ? 0 : 2), layers + 1, true, out);
+        }
+    }
+
+    std::vector<const Type*> argumentTypes(TypeTable& types) {
+        std::vector<const Type*> bases;
+        for (unsigned char cv : cvs) {
+            bases.push_back(types.named("int", cv));
+            bases.push_back(types.named("std::string", cv));
+        }
+        bases.push_back(parseType("void()", types));
+        bases.push_back(parseType("int(char, ...)", types));
+
+        std::vector<const Type*> out;
+        for (const Type* base : bases) {
+            addLayers(types, base, 0, false, out);
+        }
+        // Two that do not pack: four layers, and a second array.
+        out.push_back(parseType("int****", types));
+        out.push_back(parseType("int(*[2])[3]", types));
+        return out;
+    }
+
+    bool sameResult(DeductionResult lhs, DeductionResult rhs) {
+        return lhs.param == rhs.param && lhs.T == rhs.T;
+    }
+
+    void report(const char* kernel, DeductionForm form, const Type* arg, ValueCategory category,
+                DeductionResult expected, DeductionResult actual) {
+        auto const name = [](const Type* type) {
+            return type == nullptr ? std::string("<none>") : std::string(printType(type).view());
+        };
+        std::cerr << kernel << ", " << deductionFormNames[static_cast<std::size_t>(form)] << "(" << name(arg) << ", "
+                  << valueCategoryName(category) << "): engine " << name(expected.param) << " / " << name(expected.T)
+                  << ", batch " << name(actual.param) << " / " << name(actual.T) << '\n';
+    }
+}
+
+int main() {
+    TypeTable types;
+    DeductionEngine engine(types);
+    PackedTypeCodec codec(types);
+
+    std::vector<const Type*> args;
+    std::vector<ValueCategory> categories;
+    for (const Type* type : argumentTypes(types)) {
+        for (ValueCategory category : { ValueCategory::lvalue, ValueCategory::xvalue, ValueCategory::prvalue }) {
+            args.push_back(type);
+            categories.push_back(category);
+        }
+    }
+    if (args.size() % 2 == 0) {
+        args.pop_back();
+        categories.pop_back();
+    }
+
+    std::vector<PackedType> packedArgs;
+    std::vector<ValueCategory> packedCategories;
+    std::vector<std::size_t> indices;
+    for (std::size_t i = 0; i < args.size(); ++i) {
+        PackedType const packed = codec.pack(args[i]);
+        if (packed != packed::none) {
+            packedArgs.push_back(packed);
+            packedCategories.push_back(categories[i]);
+            indices.push_back(i);
+        }
+    }
+
+    std::size_t kernels = 0;
+    std::vector<PackedType> params(packedArgs.size());
+    std::vector<PackedType> Ts(packedArgs.size());
+    std::vector<DeductionResult> results(args.size());
+    for (std::size_t f = 0; f < deductionFormCount; ++f) {
+        DeductionForm const form = static_cast<DeductionForm>(f);
+
+        for (BatchKernel kernel : { BatchKernel::scalar, BatchKernel::sse41, BatchKernel::avx2 }) {
+            if (!batchKernelSupported(kernel)) {
+                continue;
+            }
+            kernels += f == 0;
+            deduceBatch(kernel, form, packedArgs.data(), packedCategories.data(), packedArgs.size(), params.data(), Ts.data());
+            for (std::size_t j = 0; j < packedArgs.size(); ++j) {
+                std::size_t const i = indices[j];
+                DeductionResult const expected = engine.compute(args[i], categories[i], form);
+                DeductionResult const actual = { codec.unpack(params[j]), codec.unpack(Ts[j]) };
+                if (!sameResult(expected, actual)) {
+                    ++failures;
+                    report(kernelNames[static_cast<std::size_t>(kernel)], form, args[i], categories[i], expected, actual);
+                }
+            }
+        }
+
+        deduceBatch(engine, codec, form, args.data(), categories.data(), args.size(), results.data());
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            DeductionResult const expected = engine.compute(args[i], categories[i], form);
+            if (!sameResult(expected, results[i])) {
+                ++failures;
+                report("model types", form, args[i], categories[i], expected, results[i]);
+            }
+        }
+    }
+
+    std::cout << args.size() << " arguments (" << packedArgs.size() << " packed) x " << deductionFormCount << " forms on "
+              << kernels << " kernels, " << failures << " mismatches\n";
+    return failures == 0 ? 0 : 1;
+}
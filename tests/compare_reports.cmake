@@ -0,0 +1,23 @@
+# Runs two report binaries and fails unless they print the same bytes.
+#
+#   cmake -DLHS=<binary> -DRHS=<binary> -DWORK=<dir> -P compare_reports.cmake
+#
+# Both outputs are left in WORK for diffing when they differ.
+
+get_filename_component(lhsName "${LHS}" NAME)
+get_filename_component(rhsName "${RHS}" NAME)
+set(lhsFile "${WORK}/${lhsName}.out")
+set(rhsFile "${WORK}/${rhsName}.out")
+
+foreach (side lhs rhs)
+    string(TOUPPER "${side}" binary)
+    execute_process(COMMAND "${${binary}}" OUTPUT_FILE "${${side}File}" RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "${${binary}} failed: ${result}")
+    endif()
+endforeach()
+
+execute_process(COMMAND "${CMAKE_COMMAND}" -E compare_files "${lhsFile}" "${rhsFile}" RESULT_VARIABLE different)
+if (different)
+    message(FATAL_ERROR "${lhsName} and ${rhsName} print different reports; diff ${lhsFile} ${rhsFile}")
+endif()
@@ -0,0 +1,216 @@
+// The persistent deduction cache: what it opens, and writers in parallel.
+//
+// A file that is not a cache must be refused and left as it is, an empty one
+// becomes a cache, and a damaged header or slot must raise an error rather
+// than send a lookup out of the mapping. Then several processes insert
+// overlapping key sets into one file, growing it a few times on the way, and
+// every key must end up in it exactly once with its own answer.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../deduction_cache.hpp"
+
+namespace {
+    using ttd::CachedDeduction;
+    using ttd::DeductionCache;
+    using ttd::DeductionForm;
+    using ttd::ValueCategory;
+
+    std::size_t failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            ++failures;
+            std::cerr << "failed: " << what << '\n';
+        }
+    }
+
+    template <typename F>
+    bool throws(F&& f) {
+        try {
+            f();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        std::ostringstream text;
+        text << in.rdbuf();
+        return text.str();
+    }
+
+    void writeFile(const std::string& path, const std::string& text) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    }
+
+    // Overwrites size bytes at offset, as a stray writer would.
+    void patch(const std::string& path, std::size_t offset, const void* bytes, std::size_t size) {
+        int const fd = ::open(path.c_str(), O_WRONLY);
+        check(fd >= 0 && ::pwrite(fd, bytes, size, static_cast<off_t>(offset)) == static_cast<ssize_t>(size), "patch " + path);
+        ::close(fd);
+    }
+
+    // The file layout, as deduction_cache.cpp writes it.
+    constexpr std::size_t slotCountOffset = 16;
+    constexpr std::size_t headerSize = 48;
+    constexpr std::size_t slotSize = 32;
+    constexpr std::size_t slotArgOffset = 8;
+
+    struct Key {
+        std::string arg;
+        ValueCategory category;
+        DeductionForm form;
+    };
+
+    Key key(std::size_t k) {
+        return { std::string("T").append(std::to_string(k)), static_cast<ValueCategory>(k % 3),
+                 static_cast<DeductionForm>(k % ttd::deductionFormCount) };
+    }
+
+    std::string paramOf(const Key& key) {
+        return key.arg + "&";
+    }
+
+    void checkOpening(const std::string& directory) {
+        std::string const text = directory + "/notes.txt";
+        writeFile(text, "not a cache, and longer than a cache header would be\n");
+        check(throws([&] { DeductionCache cache(text, DeductionCache::Mode::readWrite); }), "a text file is refused");
+        check(readFile(text) == "not a cache, and longer than a cache header would be\n", "a refused file is left alone");
+
+        std::string const empty = directory + "/empty.cache";
+        writeFile(empty, "");
+        check(throws([&] { DeductionCache cache(empty); }), "an empty file is not a cache to read");
+        {
+            DeductionCache cache(empty, DeductionCache::Mode::readWrite);
+            cache.insert("int", ValueCategory::lvalue, DeductionForm::passByRef, "int&", "int");
+        }
+        CachedDeduction answer;
+        DeductionCache cache(empty);
+        check(cache.find("int", ValueCategory::lvalue, DeductionForm::passByRef, answer) && answer.param == "int&",
+              "an empty file becomes a cache");
+    }
+
+    void checkDamage(const std::string& directory) {
+        std::string const path = directory + "/damaged.cache";
+        auto const fresh = [&] {
+            ::unlink(path.c_str());
+            DeductionCache cache(path, DeductionCache::Mode::readWrite);
+            cache.insert("int", ValueCategory::lvalue, DeductionForm::passByRef, "int&", "int");
+        };
+
+        fresh();
+        std::uint64_t const three = 3;
+        patch(path, slotCountOffset, &three, sizeof(three));
+        check(throws([&] { DeductionCache cache(path); }), "a slot count that is not a power of two is refused");
+
+        fresh();
+        std::uint64_t const huge = std::uint64_t(1) << 62;
+        patch(path, slotCountOffset, &huge, sizeof(huge));
+        check(throws([&] { DeductionCache cache(path); }), "a slot count past the file is refused");
+
+        // Point every slot's argument past the heap; whichever one holds the
+        // entry must be caught on lookup.
+        fresh();
+        std::uint32_t const offset = 0xfffffff0u;
+        for (std::size_t i = 0; i < 4096; ++i) {
+            patch(path, headerSize + i * slotSize + slotArgOffset, &offset, sizeof(offset));
+        }
+        CachedDeduction answer;
+        check(throws([&] {
+            DeductionCache cache(path);
+            cache.find("int", ValueCategory::lvalue, DeductionForm::passByRef, answer);
+        }), "a slot pointing out of the heap is refused");
+    }
+
+    // Each writer inserts keys [first, first + count) and finds each one
+    // straight after.
+    int writer(const std::string& path, std::size_t first, std::size_t count) {
+        try {
+            DeductionCache cache(path, DeductionCache::Mode::readWrite);
+            for (std::size_t k = first; k < first + count; ++k) {
+                Key const key = ::key(k);
+                cache.insert(key.arg, key.category, key.form, paramOf(key), key.arg);
+                CachedDeduction answer;
+                if (!cache.find(key.arg, key.category, key.form, answer) || answer.param != paramOf(key)) {
+                    return 1;
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << '\n';
+            return 1;
+        }
+        return 0;
+    }
+
+    void checkWriters(const std::string& directory) {
+        std::string const path = directory + "/shared.cache";
+        constexpr std::size_t writers = 4;
+        constexpr std::size_t perWriter = 6000;
+        constexpr std::size_t stride = 4000;    // neighbours share a third of their keys
+
+        pid_t children[writers];
+        for (std::size_t w = 0; w < writers; ++w) {
+            children[w] = ::fork();
+            if (children[w] == 0) {
+                std::_Exit(writer(path, w * stride, perWriter));
+            }
+        }
+        for (pid_t child : children) {
+            int status = 0;
+            check(child > 0 && ::waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0,
+                  "a writer finishes cleanly");
+        }
+
+        std::size_t const keys = (writers - 1) * stride + perWriter;
+        DeductionCache cache(path);
+        check(cache.size() == keys, "every key is in the cache once: " + std::to_string(cache.size()) + " of " + std::to_string(keys));
+        check(cache.capacity() > 4096, "the cache grew");
+        std::size_t missing = 0;
+        for (std::size_t k = 0; k < keys; ++k) {
+            Key const key = ::key(k);
+            CachedDeduction answer;
+            missing += !cache.find(key.arg, key.category, key.form, answer) || answer.param != paramOf(key) || answer.T != key.arg;
+        }
+        check(missing == 0, std::to_string(missing) + " keys missing or wrong");
+    }
+}
+
+int main() {
+    char directory[] = "/tmp/ttd-cache-test.XXXXXX";
+    if (::mkdtemp(directory) == nullptr) {
+        std::perror("mkdtemp");
+        return 1;
+    }
+
+    try {
+        checkOpening(directory);
+        checkDamage(directory);
+        checkWriters(directory);
+    } catch (const std::exception& e) {
+        ++failures;
+        std::cerr << "unexpected: " << e.what() << '\n';
+    }
+
+    for (const char* name : { "notes.txt", "empty.cache", "damaged.cache", "shared.cache" }) {
+        ::unlink((std::string(directory) + "/" + name).c_str());
+    }
+    ::rmdir(directory);
+
+    std::cout << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+// ttd::DeductionEngine against the compiler on every case of the report.
+//
+// The compiler's answer is the one the report prints: the case's param and T
+// as named by the constexpr backend. The engine is given the declared type of
+// the argument and its value category. Both answers are parsed and printed
+// back in ttd::printType's default style before they are compared, and the
+// engine must find no deduction exactly where the compiler finds none.
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../deduction_engine.hpp"
+#include "../report_cases.hpp"
+#include "../type_name.hpp"
+#include "../type_parser.hpp"
+#include "../type_printer.hpp"
+
+namespace {
+    std::size_t failures = 0;
+
+    std::string normalize(std::string_view name, ttd::TypeTable& types) {
+        const ttd::Type* const type = ttd::parseType(name, types);
+        if (type == nullptr) {
+            return "<unparsed " + std::string(name) + ">";
+        }
+        return std::string(ttd::printType(type).view());
+    }
+
+    std::string normalize(const ttd::Type* type) {
+        return type == nullptr ? std::string("<null>") : std::string(ttd::printType(type).view());
+    }
+
+    template <typename Case>
+    void checkCase(ttd::DeductionEngine& engine, ttd::DeductionForm form, std::string_view formName, std::string_view declared) {
+        ttd::TypeTable& types = engine.types();
+        const ttd::Type* const arg = ttd::parseType(declared, types);
+        if (arg == nullptr) {
+            ++failures;
+            std::cerr << formName << ": cannot parse argument " << declared << '\n';
+            return;
+        }
+
+        ttd::DeductionResult const result = engine.deduce(arg, Case::category, form);
+        std::string const where = std::string(formName) + "(" + std::string(declared) + ", "
+                                  + std::string(ttd::valueCategoryName(Case::category)) + ")";
+        if constexpr (Case::viable) {
+            std::string const param = normalize(ttd::constexprTypeName<typename Case::param>(), types);
+            std::string const type = normalize(ttd::constexprTypeName<typename Case::type>(), types);
+            if (!result.viable()) {
+                ++failures;
+                std::cerr << where << ": compiler deduces " << param << " / " << type << ", engine nothing\n";
+            } else if (normalize(result.param) != param || normalize(result.T) != type) {
+                ++failures;
+                std::cerr << where << ": compiler deduces " << param << " / " << type
+                          << ", engine " << normalize(result.param) << " / " << normalize(result.T) << '\n';
+            }
+        } else if (result.viable()) {
+            ++failures;
+            std::cerr << where << ": compiler deduces nothing, engine "
+                      << normalize(result.param) << " / " << normalize(result.T) << '\n';
+        }
+    }
+
+    template <typename Form, typename... Args>
+    void checkForm(ttd::DeductionEngine& engine, ttd::DeductionForm form, ttd::TypeList<Args...>) {
+        (checkCase<ttd::Case<Args, Form>>(engine, form, Form::name, ttd::constexprTypeName<typename Args::declared>()), ...);
+    }
+
+    // DeductionForms lists the forms in DeductionForm order.
+    template <typename... Forms, std::size_t... Is>
+    void checkForms(ttd::DeductionEngine& engine, ttd::TypeList<Forms...>, std::index_sequence<Is...>) {
+        (checkForm<Forms>(engine, static_cast<ttd::DeductionForm>(Is), ttd::ReportArguments{}), ...);
+    }
+}
+
+int main() {
+    static_assert(ttd::DeductionForms::size == ttd::deductionFormCount);
+    ttd::TypeTable types;
+    ttd::DeductionEngine engine(types);
+    checkForms(engine, ttd::DeductionForms{}, std::make_index_sequence<ttd::deductionFormCount>{});
+
+    std::cout << ttd::ReportMatrix::combinationCount << " cases, " << failures << " mismatches\n";
+    return failures == 0 ? 0 : 1;
+}
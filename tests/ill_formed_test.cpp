@@ -0,0 +1,72 @@
+// The declarator parser on spellings that name no type.
+//
+// Each spelling is well-formed as far as the grammar goes but breaks a rule
+// of the type system, and must be rejected rather than read as some nearby
+// type. Its well-formed neighbour must still parse.
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+
+#include "../type_parser.hpp"
+#include "../type_printer.hpp"
+
+namespace {
+    std::size_t failures = 0;
+
+    struct Rejection {
+        std::string_view spelling;
+        std::string_view neighbour;     // a valid type close to it
+    };
+
+    constexpr Rejection rejections[] = {
+        { "void()()", "void(*())()" },                  // function returning a function
+        { "int()[2]", "int(*())[2]" },                  // function returning an array
+        { "int(char)[2][3]", "int(*(char))[2][3]" },
+        { "int[2]()", "int(*[2])()" },                  // array of functions
+        { "int&[2]", "int(&)[2]" },                     // array of references
+        { "int&&[]", "int(&&)[]" },
+        { "void[2]", "void*[2]" },                      // array of void
+        { "int&*", "int*&" },                           // pointer to a reference
+        { "int&&* const", "int* const&&" },
+        { "void(&*)()", "void(*&)()" },
+        { "void&", "void*" },                           // reference to void
+        { "const void&&", "void const*" },
+        { "int& &", "int&" },                           // reference to a reference
+        { "int&& &", "int&&" },
+        { "void(int&*)", "void(int*&)" },               // in a parameter
+        { "void(*)(int[2]())", "void(*)(int(*[2])())" },
+        { "int int", "int" },                           // fundamental words that make no type
+        { "unsigned double", "unsigned int" },
+        { "long long long", "long long" },
+        { "signed unsigned char", "signed char" },
+        { "short long", "short int" },
+        { "long char", "long int" },
+        { "unsigned bool", "bool" },
+        { "long long double", "long double" },
+        { "void(void, int)", "void(int)" },             // void beside other parameters
+        { "void(int, void)", "void(int)" },
+        { "void(void, ...)", "void(...)" },
+        { "int[0]", "int[1]" },                         // zero and overflowing bounds
+        { "int(*)[0]", "int(*)[]" },
+        { "int[99999999999999999999999]", "int[99999999]" },
+    };
+}
+
+int main() {
+    ttd::TypeTable types;
+    for (const Rejection& r : rejections) {
+        if (const ttd::Type* const type = ttd::parseType(r.spelling, types)) {
+            ++failures;
+            std::cerr << r.spelling << ": accepted as " << ttd::printType(type).view() << '\n';
+        }
+        if (ttd::parseType(r.neighbour, types) == nullptr) {
+            ++failures;
+            std::cerr << r.neighbour << ": rejected\n";
+        }
+    }
+
+    std::cout << std::size(rejections) << " ill-formed spellings, " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Parse and print round trips of the declarator parser and the type printer.
+//
+// Every spelling is parsed, printed in each style and parsed back, and must
+// come back as the same type; the default style must print the expected
+// canonical name. Spellings of one type that differ only in const placement
+// or blanks must parse to the same Type.
+
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include "../type_parser.hpp"
+#include "../type_printer.hpp"
+
+namespace {
+    std::size_t failures = 0;
+
+    // A spelling and its name in the default style.
+    struct Spelling {
+        std::string_view spelling;
+        std::string_view canonical;
+    };
+
+    constexpr Spelling spellings[] = {
+        { "int", "int" },
+        { "const int", "int const" },
+        { "volatile int const", "int const volatile" },
+        { "unsigned long long", "unsigned long long" },
+        { "std::vector<int>", "std::vector<int>" },
+        { "int*", "int*" },
+        { "const int *const", "int const* const" },
+        { "int&", "int&" },
+        { "int&&", "int&&" },
+        { "const int&", "int const&" },
+        { "int const* const&", "int const* const&" },
+        { "int[2]", "int[2]" },
+        { "int[]", "int[]" },
+        { "const int[2]", "int const[2]" },
+        { "int(&)[2]", "int(&)[2]" },
+        { "const int (&&)[2]", "int const(&&)[2]" },
+        { "int const(* const&)[2]", "int const(* const&)[2]" },
+        { "int (*)[2][3]", "int(*)[2][3]" },
+        { "void()", "void()" },
+        { "void(void)", "void()" },
+        { "int(char, ...)", "int(char, ...)" },
+        { "void (&)()", "void(&)()" },
+        { "void(&&)()", "void(&&)()" },
+        { "void (*const)()", "void(* const)()" },
+        { "void(*&)(int, double)", "void(*&)(int, double)" },
+        { "int(*(*)())[2]", "int(*(*)())[2]" },
+        { "void(*(&)[2])(int)", "void(*(&)[2])(int)" },
+    };
+
+    constexpr ttd::PrintStyle styles[] = {
+        { ttd::ConstPlacement::east, ttd::Spacing::compact },
+        { ttd::ConstPlacement::east, ttd::Spacing::spaced },
+        { ttd::ConstPlacement::west, ttd::Spacing::compact },
+        { ttd::ConstPlacement::west, ttd::Spacing::spaced },
+    };
+
+    void checkSpelling(const Spelling& s, ttd::TypeTable& types) {
+        const ttd::Type* const type = ttd::parseType(s.spelling, types);
+        if (type == nullptr) {
+            ++failures;
+            std::cerr << "cannot parse " << s.spelling << '\n';
+            return;
+        }
+        if (ttd::printType(type).view() != s.canonical) {
+            ++failures;
+            std::cerr << s.spelling << ": printed as " << ttd::printType(type).view() << ", expected " << s.canonical << '\n';
+        }
+        for (const ttd::PrintStyle& style : styles) {
+            auto const printed = ttd::printType(type, style);
+            if (ttd::parseType(printed.view(), types) != type) {
+                ++failures;
+                std::cerr << s.spelling << ": " << printed.view() << " does not parse back to the same type\n";
+            }
+        }
+    }
+}
+
+int main() {
+    ttd::TypeTable types;
+    for (const Spelling& s : spellings) {
+        checkSpelling(s, types);
+    }
+    for (const Spelling& s : spellings) {
+        if (ttd::parseType(s.spelling, types) != ttd::parseType(s.canonical, types)) {
+            ++failures;
+            std::cerr << s.spelling << " and " << s.canonical << " parse to different types\n";
+        }
+    }
+
+    std::cout << std::size(spellings) << " spellings, " << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,64 @@
+// WorkStealingPool over many short runs in a row.
+//
+// Each run gets its own task and its own counters, and every index must be
+// run exactly once, by that run's task: a thread that left a run late and
+// went on with the previous task would show up as a count in the wrong run.
+// A throwing task must not stop the others, and run() must rethrow.
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "../work_stealing_pool.hpp"
+
+namespace {
+    std::size_t failures = 0;
+
+    void check(bool condition, const std::string& what) {
+        if (!condition) {
+            ++failures;
+            std::cerr << "failed: " << what << '\n';
+        }
+    }
+}
+
+int main() {
+    for (std::size_t threads : { 1, 2, 4, 8 }) {
+        ttd::WorkStealingPool pool(threads);
+        for (std::size_t round = 0; round < 2000; ++round) {
+            std::size_t const count = 1 + round % 37;
+            auto const runs = std::make_unique<std::atomic<int>[]>(count);
+            pool.run(count, [&](std::size_t index) {
+                runs[index].fetch_add(1, std::memory_order_relaxed);
+            });
+            for (std::size_t i = 0; i < count; ++i) {
+                if (runs[i].load() != 1) {
+                    check(false, std::to_string(threads) + " threads, round " + std::to_string(round) + ": index "
+                                 + std::to_string(i) + " ran " + std::to_string(runs[i].load()) + " times");
+                    break;
+                }
+            }
+        }
+
+        std::atomic<std::size_t> ran{ 0 };
+        bool rethrown = false;
+        try {
+            pool.run(100, [&](std::size_t index) {
+                ran.fetch_add(1, std::memory_order_relaxed);
+                if (index % 10 == 3) {
+                    throw std::runtime_error("task " + std::to_string(index));
+                }
+            });
+        } catch (const std::runtime_error&) {
+            rethrown = true;
+        }
+        check(rethrown, std::to_string(threads) + " threads: a task's exception is rethrown");
+        check(ran.load() == 100, std::to_string(threads) + " threads: every task runs despite the exceptions");
+    }
+
+    std::cout << failures << " failures\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// What the command-line tools that drive a compiler share: running a child
+// into a file, reading files back and splitting lists. POSIX only.
+//
+// The build passes the source tree and boost's include directories in; a
+// tool built by hand looks in the current directory and the default paths.
+
+#ifndef TTD_SOURCE_DIR
+#define TTD_SOURCE_DIR "."
+#endif
+#ifndef TTD_BOOST_INCLUDE_DIRS
+#define TTD_BOOST_INCLUDE_DIRS ""
+#endif
+
+namespace ttd {
+    namespace tools {
+        // The non-empty parts of text between separators.
+        inline std::vector<std::string> split(std::string_view text, char separator) {
+            std::vector<std::string> parts;
+            while (!text.empty()) {
+                std::size_t const end = text.find(separator);
+                if (end != 0) {
+                    parts.emplace_back(text.substr(0, end));
+                }
+                if (end == std::string_view::npos) {
+                    break;
+                }
+                text.remove_prefix(end + 1);
+            }
+            return parts;
+        }
+
+        // The whole file, or nothing if it cannot be read.
+        inline std::string readFile(const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            std::ostringstream text;
+            text << in.rdbuf();
+            return text.str();
+        }
+
+        // What a finished child cost.
+        struct Usage {
+            double seconds = 0;
+            long peakKb = 0;
+        };
+
+        // Where a child's stderr goes.
+        enum class Errors {
+            withOutput,
+            discarded,
+        };
+
+        // Runs argv in directory (the current one if empty) with stdout going
+        // to outputPath; true if it exits 0. Only async-signal-safe calls
+        // between fork and exec, as other threads may be running.
+        inline bool run(const std::vector<std::string>& argv, const std::string& outputPath, Usage* usage = nullptr,
+                        const std::string& directory = std::string(), Errors errors = Errors::withOutput) {
+            std::vector<char*> args;
+            for (const std::string& arg : argv) {
+                args.push_back(const_cast<char*>(arg.c_str()));
+            }
+            args.push_back(nullptr);
+
+            int const fd = ::open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                return false;
+            }
+            int const errorFd = errors == Errors::withOutput ? fd : ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+            if (errorFd < 0) {
+                ::close(fd);
+                return false;
+            }
+            auto const start = std::chrono::steady_clock::now();
+            pid_t const pid = ::fork();
+            if (pid == 0) {
+                if ((!directory.empty() && ::chdir(directory.c_str()) < 0) || ::dup2(fd, 1) < 0 || ::dup2(errorFd, 2) < 0) {
+                    ::_exit(126);
+                }
+                ::execvp(args[0], args.data());
+                ::_exit(127);
+            }
+            ::close(fd);
+            if (errorFd != fd) {
+                ::close(errorFd);
+            }
+            if (pid < 0) {
+                return false;
+            }
+
+            int status = 0;
+            rusage resources{};
+            while (::wait4(pid, &status, 0, &resources) < 0) {
+                if (errno != EINTR) {
+                    return false;
+                }
+            }
+            if (usage != nullptr) {
+                usage->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                usage->peakKb = resources.ru_maxrss;
+            }
+            return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+
+        // Runs argv with its stdout in outputPath and calls onLine with every
+        // line of it; false if the command fails. No shell is involved, so
+        // arguments need no quoting.
+        template <typename OnLine>
+        bool forEachOutputLine(const std::vector<std::string>& argv, const std::string& outputPath, OnLine onLine) {
+            if (!run(argv, outputPath, nullptr, std::string(), Errors::discarded)) {
+                return false;
+            }
+            std::ifstream in(outputPath);
+            for (std::string line; std::getline(in, line);) {
+                onLine(std::string_view(line));
+            }
+            return true;
+        }
+    }
+}
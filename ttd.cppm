@@ -0,0 +1,23 @@
+// ttd.hpp as a C++20 module: `import ttd;` gives the passBy* forms,
+// TemplateTypeInfos and typeName, compiled once instead of parsed by every
+// TU that uses them.
+//
+// The headers ttd.hpp includes go in the global module fragment, so only its
+// own declarations are attached to the module and exported.
+
+module;
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+#include "deduction_form.hpp"
+#include "deduction_probe.hpp"
+#include "scrub_type_name.hpp"
+#include "type_name.hpp"
+
+export module ttd;
+
+#define TTD_EXPORT export
+#include "ttd.hpp"
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string_view>
+#include <utility>
+
+#include "deduction_form.hpp"
+#include "deduction_probe.hpp"
+#include "type_name.hpp"
+
+// The passBy* forms and TemplateTypeInfos, for any tool that wants to ask the
+// compiler what it deduces.
+//
+// This header is kept lean: besides <string_view> and <utility> it only pulls
+// in type_name.hpp (<array> and <cstddef>) and the deduction probes, with no
+// boost and no iostreams. The names are the constexpr ones. pass_by.hpp
+// builds the report's other name backends and its output operators on top of
+// it.
+//
+// typeName is only declared here when TTD_EXTERNAL_TYPE_NAME is defined; the
+// includer then defines it, as pass_by.hpp does. ttd.cppm exports the same
+// declarations as the module `ttd`, which is what TTD_EXPORT is for.
+
+#ifndef TTD_EXPORT
+#define TTD_EXPORT
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TTD_ALWAYS_INLINE __forceinline
+#else
+#define TTD_ALWAYS_INLINE [[gnu::always_inline]] inline
+#endif
+
+TTD_EXPORT struct TemplateTypeInfos {
+    std::string_view param;
+    std::string_view T;
+};
+
+#ifdef TTD_EXTERNAL_TYPE_NAME
+template <typename T>
+std::string_view typeName();
+#else
+TTD_EXPORT template <typename T>
+std::string_view typeName() {
+    return ttd::constexprTypeName<T>();
+}
+#endif
+
+// The passBy* forms are one template, DeductionProbe, parameterized by the
+// form. Deduction is done at the type level by the form's twin in
+// deduction_probe.hpp, on the argument's type and category as a forwarding
+// reference sees them. That is exact for lvalues and xvalues; a prvalue is
+// seen as an xvalue, which only differs for a cv-qualified non-class
+// prvalue. A form that does not deduce takes the probe out of overload
+// resolution, as the template it replaces did.
+//
+// The probe is always inlined and never gets a body of its own, so a call
+// costs the two typeName<> calls and nothing per form: what is emitted is one
+// typeName<T> per type named, shared by every form and argument.
+namespace ttd {
+    namespace detail {
+        // FormProbe<Form>::deduce<Expr> is the Deduction of Form's twin for an
+        // argument of type Expr (Expr& an lvalue, Expr&& an xvalue); it does
+        // not exist when the form does not deduce.
+        template <DeductionForm Form>
+        struct FormProbe;
+
+        template <>
+        struct FormProbe<DeductionForm::passByValue> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByValue(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByRef> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByRef(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByURef> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByURef(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByPtr> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByPtr(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByCPtr> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByCPtr(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByCRef> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByCRef(std::declval<Expr>()));
+        };
+
+        template <>
+        struct FormProbe<DeductionForm::passByCRRef> {
+            template <typename Expr>
+            using deduce = decltype(probe::passByCRRef(std::declval<Expr>()));
+        };
+    }
+
+    TTD_EXPORT template <DeductionForm Form>
+    struct DeductionProbe {
+        template <typename Expr, typename Deduced = typename detail::FormProbe<Form>::template deduce<Expr&&>>
+        TTD_ALWAYS_INLINE TemplateTypeInfos operator()(Expr&&) const {
+            return {
+                typeName<typename Deduced::param>(),
+                typeName<typename Deduced::type>(),
+            };
+        }
+    };
+}
+
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByValue> passByValue{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByRef> passByRef{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByURef> passByURef{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByPtr> passByPtr{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByCPtr> passByCPtr{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByCRef> passByCRef{};
+TTD_EXPORT inline constexpr ttd::DeductionProbe<ttd::DeductionForm::passByCRRef> passByCRRef{};
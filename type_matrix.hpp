@@ -0,0 +1,410 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "context_probe.hpp"
+#include "deduction_probe.hpp"
+#include "value_category.hpp"
+
+// A compile-time registry of deduction cases.
+//
+// An argument kind says how a variable is declared and whether it is passed
+// as is or through std::move. A deduction form is one of the passBy* shapes,
+// or one of the other places the compiler deduces a type (auto, decltype(auto),
+// generic lambdas, structured bindings, CTAD); its deduce<Arg> names the
+// result as a ttd::Deduction.
+// TypeMatrix crosses every argument kind with every form. Each combination is
+// probed with a requires-expression, so the ones the compiler rejects (say,
+// an lvalue for T const&&) become "no viable deduction" cases instead of
+// breaking the build.
+
+namespace ttd {
+    template <typename... Ts>
+    struct TypeList {
+        static constexpr std::size_t size = sizeof...(Ts);
+    };
+
+    // The name of a report variable, as a template argument: Named<int, "a">.
+    // It keeps the name and the std::move call on it, so both can be printed
+    // as string_views.
+    struct VariableName {
+        static constexpr std::size_t capacity = 16;
+        static constexpr std::string_view move = "std::move(";
+
+        char name[capacity] = {};
+        char moved[move.size() + capacity + 1] = {};
+        std::size_t size = 0;
+
+        template <std::size_t N>
+        constexpr VariableName(const char (&text)[N]) : size(N - 1) {
+            static_assert(N <= capacity, "variable names are short");
+            for (std::size_t i = 0; i < move.size(); ++i) {
+                moved[i] = move[i];
+            }
+            for (std::size_t i = 0; i < size; ++i) {
+                name[i] = text[i];
+                moved[move.size() + i] = text[i];
+            }
+            moved[move.size() + size] = ')';
+        }
+    };
+
+    // The variable `Declared name;` used by name: always an lvalue. decltyped
+    // is decltype(name), which is the declared type.
+    template <typename Declared, VariableName Name>
+    struct Named {
+        using declared = Declared;
+        using printed = Declared;
+        using expr = std::remove_reference_t<Declared>&;
+        using decltyped = decltype(probe::Declaration<Declared>::id);
+        static constexpr std::string_view expression{Name.name, Name.size};
+        static constexpr bool moved = false;
+        static constexpr ValueCategory category = valueCategoryOf<expr>;
+    };
+
+    // std::move(name): an xvalue, except that function expressions stay
+    // lvalues.
+    template <typename Declared, VariableName Name>
+    struct Moved {
+        using declared = Declared;
+        using printed = std::remove_reference_t<Declared>&&;
+        using expr = printed;
+        using decltyped = decltype(std::move(probe::Declaration<Declared>::id));
+        static constexpr std::string_view expression{Name.moved, VariableName::move.size() + Name.size + 1};
+        static constexpr bool moved = true;
+        static constexpr ValueCategory category = valueCategoryOf<expr>;
+    };
+
+    namespace form {
+        struct PassByValue {
+            static constexpr std::string_view name = "passByValue";
+            static constexpr std::string_view banner =
+                "################################## Pass By Value ##################################\n"
+                "template <typename T>\n"
+                "void f(T param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByValue(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByRef {
+            static constexpr std::string_view name = "passByRef";
+            static constexpr std::string_view banner =
+                "################################## Pass By Ref ##################################\n"
+                "template <typename T>\n"
+                "void f(T& param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByRef(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByURef {
+            static constexpr std::string_view name = "passByURef";
+            static constexpr std::string_view banner =
+                "################################## Pass By URef ##################################\n"
+                "template <typename T>\n"
+                "void f(T&& param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByURef(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByPtr {
+            static constexpr std::string_view name = "passByPtr";
+            static constexpr std::string_view banner =
+                "################################## Pass By Pointer ##################################\n"
+                "template <typename T>\n"
+                "void f(T* param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByPtr(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByCPtr {
+            static constexpr std::string_view name = "passByCPtr";
+            static constexpr std::string_view banner =
+                "################################## Pass By Const Pointer ##################################\n"
+                "template <typename T>\n"
+                "void f(T const* param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByCPtr(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByCRef {
+            static constexpr std::string_view name = "passByCRef";
+            static constexpr std::string_view banner =
+                "################################## Pass By Const Reference ##################################\n"
+                "template <typename T>\n"
+                "void f(T const& param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByCRef(std::declval<typename Arg::expr>()));
+        };
+
+        struct PassByCRRef {
+            static constexpr std::string_view name = "passByCRRef";
+            static constexpr std::string_view banner =
+                "################################## Pass By Const Rvalue Reference ##################################\n"
+                "template <typename T>\n"
+                "void f(T const&& param);\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::passByCRRef(std::declval<typename Arg::expr>()));
+        };
+    }
+
+    // Deduction outside function templates. "param type" is the type of
+    // the declared entity, T what its placeholder stands for; the banners
+    // say which is which.
+    namespace form {
+        struct AutoValue {
+            static constexpr std::string_view name = "autoValue";
+            static constexpr std::string_view banner =
+                "################################## Auto ##################################\n"
+                "auto x = expr;\n"
+                "param type: decltype(x), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::autoVariable<typename Arg::expr>());
+        };
+
+        struct AutoRef {
+            static constexpr std::string_view name = "autoRef";
+            static constexpr std::string_view banner =
+                "################################## Auto Ref ##################################\n"
+                "auto& x = expr;\n"
+                "param type: decltype(x), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::autoRefVariable<typename Arg::expr>());
+        };
+
+        struct AutoURef {
+            static constexpr std::string_view name = "autoURef";
+            static constexpr std::string_view banner =
+                "################################## Auto URef ##################################\n"
+                "auto&& x = expr;\n"
+                "param type: decltype(x), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::autoURefVariable<typename Arg::expr>());
+        };
+
+        struct AutoCRef {
+            static constexpr std::string_view name = "autoCRef";
+            static constexpr std::string_view banner =
+                "################################## Auto Const Reference ##################################\n"
+                "auto const& x = expr;\n"
+                "param type: decltype(x), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::autoCRefVariable<typename Arg::expr>());
+        };
+
+        struct DecltypeAuto {
+            static constexpr std::string_view name = "decltypeAuto";
+            static constexpr std::string_view banner =
+                "################################## Decltype Auto ##################################\n"
+                "decltype(auto) f() { return expr; }\n"
+                "param type, T: the return type\n\n";
+
+            template <typename Arg>
+            using deduce = typename probe::DecltypeAuto<Arg>::type;
+        };
+
+        struct LambdaByValue {
+            static constexpr std::string_view name = "lambdaByValue";
+            static constexpr std::string_view banner =
+                "################################## Lambda By Value ##################################\n"
+                "[](auto param) { }(expr);\n"
+                "param type: decltype(param), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::lambdaByValue(std::declval<typename Arg::expr>()));
+        };
+
+        struct LambdaByRef {
+            static constexpr std::string_view name = "lambdaByRef";
+            static constexpr std::string_view banner =
+                "################################## Lambda By Ref ##################################\n"
+                "[](auto& param) { }(expr);\n"
+                "param type: decltype(param), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::lambdaByRef(std::declval<typename Arg::expr>()));
+        };
+
+        struct LambdaByURef {
+            static constexpr std::string_view name = "lambdaByURef";
+            static constexpr std::string_view banner =
+                "################################## Lambda By URef ##################################\n"
+                "[](auto&& param) { }(expr);\n"
+                "param type: decltype(param), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::lambdaByURef(std::declval<typename Arg::expr>()));
+        };
+
+        struct LambdaByCRef {
+            static constexpr std::string_view name = "lambdaByCRef";
+            static constexpr std::string_view banner =
+                "################################## Lambda By Const Reference ##################################\n"
+                "[](auto const& param) { }(expr);\n"
+                "param type: decltype(param), T: auto\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::lambdaByCRef(std::declval<typename Arg::expr>()));
+        };
+
+        struct BindByValue {
+            static constexpr std::string_view name = "bindByValue";
+            static constexpr std::string_view banner =
+                "################################## Structured Binding ##################################\n"
+                "auto [x, y] = expr;\n"
+                "param type: decltype(x), T: decltype((x))\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::bindByValue<typename Arg::expr>());
+        };
+
+        struct BindByRef {
+            static constexpr std::string_view name = "bindByRef";
+            static constexpr std::string_view banner =
+                "################################## Structured Binding By Ref ##################################\n"
+                "auto& [x, y] = expr;\n"
+                "param type: decltype(x), T: decltype((x))\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::bindByRef<typename Arg::expr>());
+        };
+
+        struct BindByURef {
+            static constexpr std::string_view name = "bindByURef";
+            static constexpr std::string_view banner =
+                "################################## Structured Binding By URef ##################################\n"
+                "auto&& [x, y] = expr;\n"
+                "param type: decltype(x), T: decltype((x))\n\n";
+
+            template <typename Arg>
+            using deduce = decltype(probe::bindByURef<typename Arg::expr>());
+        };
+
+        struct CtadByValue {
+            static constexpr std::string_view name = "ctadByValue";
+            static constexpr std::string_view banner =
+                "################################## CTAD By Value ##################################\n"
+                "template <typename T> struct Box { Box(T value); };\n"
+                "Box box{expr};\n"
+                "param type: decltype(box), T: T\n\n";
+
+            template <typename Arg>
+            using deduce = probe::ClassDeduction<decltype(Box{ std::declval<typename Arg::expr>() })>;
+        };
+
+        struct CtadByRRef {
+            static constexpr std::string_view name = "ctadByRRef";
+            static constexpr std::string_view banner =
+                "################################## CTAD By Rvalue Reference ##################################\n"
+                "template <typename T> struct Ref { Ref(T&& value); };\n"
+                "Ref ref{expr};\n"
+                "param type: decltype(ref), T: T\n\n";
+
+            template <typename Arg>
+            using deduce = probe::ClassDeduction<decltype(Ref{ std::declval<typename Arg::expr>() })>;
+        };
+    }
+
+    using ContextForms = TypeList<
+        form::AutoValue,
+        form::AutoRef,
+        form::AutoURef,
+        form::AutoCRef,
+        form::DecltypeAuto,
+        form::LambdaByValue,
+        form::LambdaByRef,
+        form::LambdaByURef,
+        form::LambdaByCRef,
+        form::BindByValue,
+        form::BindByRef,
+        form::BindByURef,
+        form::CtadByValue,
+        form::CtadByRRef
+    >;
+
+    using DeductionForms = TypeList<
+        form::PassByValue,
+        form::PassByRef,
+        form::PassByURef,
+        form::PassByPtr,
+        form::PassByCPtr,
+        form::PassByCRef,
+        form::PassByCRRef
+    >;
+
+    // Whether Arg deduces in Form at all.
+#ifdef __cpp_concepts
+    template <typename Form, typename Arg>
+    concept Deducible = requires {
+        typename Form::template deduce<Arg>;
+    };
+#else
+    namespace detail {
+        template <typename Form, typename Arg, typename = void>
+        struct IsDeducible : std::false_type { };
+
+        template <typename Form, typename Arg>
+        struct IsDeducible<Form, Arg, std::void_t<typename Form::template deduce<Arg>>> : std::true_type { };
+    }
+
+    template <typename Form, typename Arg>
+    constexpr bool Deducible = detail::IsDeducible<Form, Arg>::value;
+#endif
+
+    // One row of the report: the expression passed, its type and value
+    // category, what the parameter becomes, and T. Only viable cases have a
+    // param and a type.
+    // categoryConstant lets a driver pick an overload by category.
+    template <typename Arg, typename Form, bool = Deducible<Form, Arg>>
+    struct Case {
+        using arg = typename Arg::printed;
+        static constexpr std::string_view expression = Arg::expression;
+        static constexpr ValueCategory category = Arg::category;
+        using categoryConstant = ValueCategoryConstant<category>;
+        static constexpr bool viable = false;
+    };
+
+    template <typename Arg, typename Form>
+    struct Case<Arg, Form, true> {
+        using arg = typename Arg::printed;
+        static constexpr std::string_view expression = Arg::expression;
+        static constexpr ValueCategory category = Arg::category;
+        using categoryConstant = ValueCategoryConstant<category>;
+        using param = typename Form::template deduce<Arg>::param;
+        using type = typename Form::template deduce<Arg>::type;
+        static constexpr bool viable = true;
+    };
+
+    template <typename Args, typename Forms>
+    struct TypeMatrix;
+
+    template <typename... Args, typename... Forms>
+    struct TypeMatrix<TypeList<Args...>, TypeList<Forms...>> {
+        using forms = TypeList<Forms...>;
+
+        // All cases of one form, in argument order.
+        template <typename Form>
+        using cases = TypeList<Case<Args, Form>...>;
+
+        template <typename Form>
+        static constexpr std::size_t viableCountOf = (std::size_t(Case<Args, Form>::viable) + ... + 0);
+
+        static constexpr std::size_t argumentCount = sizeof...(Args);
+        static constexpr std::size_t formCount = sizeof...(Forms);
+        static constexpr std::size_t combinationCount = argumentCount * formCount;
+        static constexpr std::size_t viableCount = (viableCountOf<Forms> + ... + 0);
+    };
+}
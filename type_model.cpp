@@ -0,0 +1,137 @@
+#include "type_model.hpp"
+
+namespace ttd {
+    namespace {
+        std::size_t combine(std::size_t seed, std::size_t value) {
+            return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+        }
+
+        Type makeNode(TypeKind kind, unsigned char cv, const Type* element) {
+            return Type{ kind, cv, false, std::string_view(), element, 0, nullptr, 0 };
+        }
+    }
+
+    std::size_t TypeTable::NodeHash::operator()(const Type* type) const {
+        std::size_t seed = static_cast<std::size_t>(type->kind);
+        seed = combine(seed, type->cv);
+        seed = combine(seed, type->variadic);
+        seed = combine(seed, std::hash<std::string_view>()(type->name));
+        seed = combine(seed, std::hash<const Type*>()(type->element));
+        seed = combine(seed, type->bound);
+        for (std::size_t i = 0; i < type->paramCount; ++i) {
+            seed = combine(seed, std::hash<const Type*>()(type->params[i]));
+        }
+        return seed;
+    }
+
+    bool TypeTable::NodeEqual::operator()(const Type* lhs, const Type* rhs) const {
+        if (lhs->kind != rhs->kind || lhs->cv != rhs->cv || lhs->variadic != rhs->variadic
+            || lhs->name != rhs->name || lhs->element != rhs->element
+            || lhs->bound != rhs->bound || lhs->paramCount != rhs->paramCount) {
+            return false;
+        }
+        for (std::size_t i = 0; i < lhs->paramCount; ++i) {
+            if (lhs->params[i] != rhs->params[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Type* TypeTable::intern(const Type& key) {
+        auto const found = _index.find(&key);
+        if (found != _index.end()) {
+            return *found;
+        }
+
+        Type node = key;
+        if (!key.name.empty()) {
+            node.name = _names.emplace_back(key.name);
+        }
+        if (key.paramCount > 0) {
+            node.params = _paramLists.emplace_back(key.params, key.params + key.paramCount).data();
+        }
+
+        const Type* const interned = &_nodes.emplace_back(node);
+        _index.insert(interned);
+        return interned;
+    }
+
+    const Type* TypeTable::named(std::string_view name, unsigned char cv) {
+        Type key = makeNode(TypeKind::named, cv, nullptr);
+        key.name = name;
+        return intern(key);
+    }
+
+    const Type* TypeTable::pointerTo(const Type* pointee, unsigned char cv) {
+        // There are no pointers to references, T&* is T*.
+        if (pointee->isReference()) {
+            pointee = pointee->element;
+        }
+        return intern(makeNode(TypeKind::pointer, cv, pointee));
+    }
+
+    const Type* TypeTable::lvalueReferenceTo(const Type* referee) {
+        if (referee->isReference()) {
+            referee = referee->element;
+        }
+        return intern(makeNode(TypeKind::lvalueReference, cvNone, referee));
+    }
+
+    const Type* TypeTable::rvalueReferenceTo(const Type* referee) {
+        if (referee->kind == TypeKind::lvalueReference) {
+            return referee;
+        }
+        if (referee->kind == TypeKind::rvalueReference) {
+            referee = referee->element;
+        }
+        return intern(makeNode(TypeKind::rvalueReference, cvNone, referee));
+    }
+
+    const Type* TypeTable::arrayOf(const Type* element, std::size_t bound) {
+        Type key = makeNode(TypeKind::array, cvNone, element);
+        key.bound = bound;
+        return intern(key);
+    }
+
+    const Type* TypeTable::function(const Type* result, const Type* const* params, std::size_t paramCount, bool variadic) {
+        Type key = makeNode(TypeKind::function, cvNone, result);
+        key.params = params;
+        key.paramCount = paramCount;
+        key.variadic = variadic;
+        return intern(key);
+    }
+
+    const Type* TypeTable::withCv(const Type* type, unsigned char cv) {
+        switch (type->kind) {
+        case TypeKind::named:
+            return (type->cv | cv) == type->cv ? type : named(type->name, static_cast<unsigned char>(type->cv | cv));
+        case TypeKind::pointer:
+            return (type->cv | cv) == type->cv ? type : pointerTo(type->element, static_cast<unsigned char>(type->cv | cv));
+        case TypeKind::array:
+            return arrayOf(withCv(type->element, cv), type->bound);
+        default:
+            return type;
+        }
+    }
+
+    const Type* TypeTable::withoutCv(const Type* type, unsigned char cv) {
+        switch (type->kind) {
+        case TypeKind::named:
+            return (type->cv & cv) == 0 ? type : named(type->name, static_cast<unsigned char>(type->cv & ~cv));
+        case TypeKind::pointer:
+            return (type->cv & cv) == 0 ? type : pointerTo(type->element, static_cast<unsigned char>(type->cv & ~cv));
+        case TypeKind::array:
+            return arrayOf(withoutCv(type->element, cv), type->bound);
+        default:
+            return type;
+        }
+    }
+
+    unsigned char TypeTable::cvOf(const Type* type) {
+        while (type->kind == TypeKind::array) {
+            type = type->element;
+        }
+        return type->kind == TypeKind::named || type->kind == TypeKind::pointer ? type->cv : static_cast<unsigned char>(cvNone);
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// A runtime model of the C++ types the report talks about.
+//
+// Types are hash-consed: a TypeTable hands out each distinct type exactly once,
+// so two Type pointers are equal if and only if the types are, and a composite
+// type shares its parts with every other type built from them.
+//
+// The model follows the language rules that matter for deduction:
+//   - cv-qualifiers on an array belong to its elements,
+//   - cv-qualifiers on references and functions are ignored,
+//   - a reference to a reference collapses (& wins over &&).
+
+namespace ttd {
+    enum class TypeKind : unsigned char {
+        named,              // fundamental or class type, e.g. `int`, `std::string`
+        pointer,
+        lvalueReference,
+        rvalueReference,
+        array,
+        function,
+    };
+
+    enum Cv : unsigned char {
+        cvNone = 0,
+        cvConst = 1,
+        cvVolatile = 2,
+        cvConstVolatile = cvConst | cvVolatile,
+    };
+
+    struct Type {
+        TypeKind kind;
+        unsigned char cv;
+        bool variadic;                  // function: ends in `...`
+        std::string_view name;          // named
+        const Type* element;            // pointee, referee, array element or function result
+        std::size_t bound;              // array: number of elements, 0 for `T[]`
+        const Type* const* params;      // function parameters
+        std::size_t paramCount;
+
+        bool isReference() const {
+            return kind == TypeKind::lvalueReference || kind == TypeKind::rvalueReference;
+        }
+    };
+
+    class TypeTable {
+    public:
+        TypeTable() = default;
+        TypeTable(const TypeTable&) = delete;
+        TypeTable& operator=(const TypeTable&) = delete;
+
+        const Type* named(std::string_view name, unsigned char cv = cvNone);
+        const Type* pointerTo(const Type* pointee, unsigned char cv = cvNone);
+        const Type* lvalueReferenceTo(const Type* referee);
+        const Type* rvalueReferenceTo(const Type* referee);
+        const Type* arrayOf(const Type* element, std::size_t bound);
+        const Type* function(const Type* result, const Type* const* params, std::size_t paramCount, bool variadic = false);
+
+        // Adds cv to the top level (to the elements of an array).
+        const Type* withCv(const Type* type, unsigned char cv);
+        // Removes cv from the top level (from the elements of an array).
+        const Type* withoutCv(const Type* type, unsigned char cv = cvConstVolatile);
+        // The cv-qualifiers that apply to the top level of type.
+        static unsigned char cvOf(const Type* type);
+
+        std::size_t size() const {
+            return _nodes.size();
+        }
+
+    private:
+        struct NodeHash {
+            std::size_t operator()(const Type* type) const;
+        };
+
+        struct NodeEqual {
+            bool operator()(const Type* lhs, const Type* rhs) const;
+        };
+
+        const Type* intern(const Type& key);
+
+        std::deque<Type> _nodes;
+        std::deque<std::string> _names;
+        std::deque<std::vector<const Type*>> _paramLists;
+        std::unordered_set<const Type*, NodeHash, NodeEqual> _index;
+    };
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "scrub_type_name.hpp"
+
+// Compile-time type names.
+//
+// The compiler already spells the template argument inside __PRETTY_FUNCTION__
+// (__FUNCSIG__ on MSVC), so the name of T is just a slice of that string. The
+// slice is scrubbed and copied into a constexpr array once per T, and every
+// query afterwards is a std::string_view into static storage: no demangling,
+// no allocation.
+
+namespace ttd {
+    namespace detail {
+        template <typename T>
+        constexpr std::string_view rawTypeName() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            return __FUNCSIG__;
+#else
+            return __PRETTY_FUNCTION__;
+#endif
+        }
+
+        // rawTypeName<int>() tells where the type starts and how much trails it,
+        // both are the same for every T.
+        constexpr std::string_view probeName = rawTypeName<int>();
+        constexpr std::size_t prefixLength = probeName.find("int");
+        constexpr std::size_t suffixLength = probeName.size() - prefixLength - 3;
+
+        // Except on GCC in a TU that imports the ttd module, where the text
+        // around T spells std::string_view as `std::string_view@ttd`. GCC
+        // ends the type with a `;`, which no type contains, so there the
+        // type is found between `T = ` and that `;` instead.
+        constexpr bool endsAtSemicolon = probeName[prefixLength + 3] == ';';
+        constexpr std::string_view typeOpener = probeName.substr(prefixLength - 4, 4);
+
+        template <typename T>
+        constexpr std::string_view slicedTypeName() {
+            constexpr std::string_view raw = rawTypeName<T>();
+            if constexpr (endsAtSemicolon) {
+                constexpr std::size_t begin = raw.find(typeOpener) + typeOpener.size();
+                return raw.substr(begin, raw.find(';', begin) - begin);
+            } else {
+                return raw.substr(prefixLength, raw.size() - prefixLength - suffixLength);
+            }
+        }
+
+        template <std::size_t N>
+        struct ScrubbedName {
+            std::array<char, N + 1> chars{};
+            std::size_t size = 0;
+        };
+
+        template <std::size_t N>
+        constexpr ScrubbedName<N> scrubbed(std::string_view s) {
+            ScrubbedName<N> name;
+            for (std::size_t i = 0; i < s.size(); ++i) {
+                name.chars[i] = s[i];
+            }
+            name.size = scrubTypeName(name.chars.data(), s.size());
+            return name;
+        }
+
+        template <typename T>
+        struct ConstexprTypeName {
+            static constexpr std::string_view sliced = slicedTypeName<T>();
+            static constexpr ScrubbedName<sliced.size()> storage = scrubbed<sliced.size()>(sliced);
+            static constexpr std::string_view value = std::string_view(storage.chars.data(), storage.size);
+        };
+    }
+
+    template <typename T>
+    constexpr std::string_view constexprTypeName() {
+        return detail::ConstexprTypeName<T>::value;
+    }
+}
@@ -0,0 +1,468 @@
+#include "type_parser.hpp"
+
+#include <cstddef>
+#include <limits>
+
+namespace ttd {
+    namespace {
+        constexpr std::size_t maxNameLength = 256;
+        constexpr std::size_t maxParams = 16;
+        constexpr int maxDepth = 128;
+
+        bool isIdentifierStart(char c) {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        }
+
+        bool isIdentifierChar(char c) {
+            return isIdentifierStart(c) || (c >= '0' && c <= '9');
+        }
+
+        bool isBlank(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        bool isFundamentalWord(std::string_view word) {
+            return word == "int" || word == "char" || word == "void" || word == "bool"
+                || word == "unsigned" || word == "signed" || word == "short" || word == "long"
+                || word == "float" || word == "double" || word == "wchar_t"
+                || word == "char8_t" || word == "char16_t" || word == "char32_t";
+        }
+
+        // The fundamental words of one decl-specifier-seq, counted, to tell
+        // `unsigned long long int` from `int int` or `unsigned double`.
+        struct FundamentalWords {
+            int sign = 0;               // signed, unsigned
+            int shorts = 0;
+            int longs = 0;
+            int ints = 0;
+            int chars = 0;              // char, which takes a sign
+            int doubles = 0;
+            int others = 0;             // void, bool, float, wchar_t, char8_t, ...
+
+            void add(std::string_view word) {
+                if (word == "signed" || word == "unsigned") {
+                    ++sign;
+                } else if (word == "short") {
+                    ++shorts;
+                } else if (word == "long") {
+                    ++longs;
+                } else if (word == "int") {
+                    ++ints;
+                } else if (word == "char") {
+                    ++chars;
+                } else if (word == "double") {
+                    ++doubles;
+                } else {
+                    ++others;
+                }
+            }
+
+            bool valid() const {
+                if (sign > 1 || shorts > 1 || longs > 2 || ints + chars + doubles + others > 1 || (shorts > 0 && longs > 0)) {
+                    return false;
+                }
+                if (chars > 0) {
+                    return shorts + longs == 0;
+                }
+                if (doubles > 0) {
+                    return sign + shorts == 0 && longs <= 1;
+                }
+                if (others > 0) {
+                    return sign + shorts + longs == 0;
+                }
+                return true;
+            }
+        };
+
+        bool isVoid(const Type* type) {
+            return type->kind == TypeKind::named && type->name == "void";
+        }
+
+        class Parser {
+        public:
+            Parser(std::string_view text, TypeTable& types) : _types(types), _text(text) { }
+
+            const Type* parseAll() {
+                const Type* const type = parseTypeId();
+                skipBlanks();
+                return type != nullptr && _pos == _text.size() ? type : nullptr;
+            }
+
+        private:
+            TypeTable& _types;
+            std::string_view _text;
+            std::size_t _pos = 0;
+            int _depth = 0;
+
+            // Guards every recursive production against runaway nesting.
+            struct Nesting {
+                Parser& parser;
+                explicit Nesting(Parser& p) : parser(p) { ++parser._depth; }
+                ~Nesting() { --parser._depth; }
+                bool tooDeep() const { return parser._depth > maxDepth; }
+            };
+
+            void skipBlanks() {
+                while (_pos < _text.size() && isBlank(_text[_pos])) {
+                    ++_pos;
+                }
+            }
+
+            bool peek(char c) {
+                skipBlanks();
+                return _pos < _text.size() && _text[_pos] == c;
+            }
+
+            bool consume(char c) {
+                if (peek(c)) {
+                    ++_pos;
+                    return true;
+                }
+                return false;
+            }
+
+            std::string_view peekWord() {
+                skipBlanks();
+                std::size_t end = _pos;
+                if (end < _text.size() && isIdentifierStart(_text[end])) {
+                    while (end < _text.size() && isIdentifierChar(_text[end])) {
+                        ++end;
+                    }
+                }
+                return _text.substr(_pos, end - _pos);
+            }
+
+            unsigned char parseCv() {
+                unsigned char cv = cvNone;
+                for (;;) {
+                    std::string_view const word = peekWord();
+                    if (word == "const") {
+                        cv |= cvConst;
+                    } else if (word == "volatile") {
+                        cv |= cvVolatile;
+                    } else {
+                        return cv;
+                    }
+                    _pos += word.size();
+                }
+            }
+
+            // Copies a possibly qualified, possibly templated name into name,
+            // with single blanks between tokens that need them.
+            bool appendName(char* name, std::size_t& length) {
+                auto append = [&](char c) {
+                    if (length == maxNameLength) {
+                        return false;
+                    }
+                    name[length++] = c;
+                    return true;
+                };
+
+                int angles = 0;
+                bool blank = false;
+                while (_pos < _text.size()) {
+                    char const c = _text[_pos];
+                    if (isBlank(c)) {
+                        blank = true;
+                        ++_pos;
+                        continue;
+                    }
+                    bool const continues = angles > 0
+                        || c == '<'
+                        || (c == ':' && _pos + 1 < _text.size() && _text[_pos + 1] == ':')
+                        || (isIdentifierChar(c) && !blank)
+                        || (isIdentifierChar(c) && length > 0 && (name[length - 1] == ':'));
+                    if (!continues) {
+                        break;
+                    }
+                    if (blank && length > 0 && isIdentifierChar(c) && isIdentifierChar(name[length - 1]) && !append(' ')) {
+                        return false;
+                    }
+                    if (c == '<') {
+                        ++angles;
+                    } else if (c == '>') {
+                        if (angles == 0) {
+                            break;
+                        }
+                        --angles;
+                        if (length > 0 && name[length - 1] == '>' && !append(' ')) {
+                            return false;
+                        }
+                    } else if (c == ',') {
+                        if (!append(',') || !append(' ')) {
+                            return false;
+                        }
+                        ++_pos;
+                        blank = false;
+                        continue;
+                    } else if (c == ':' && angles == 0) {
+                        if (!append(':')) {
+                            return false;
+                        }
+                        ++_pos;
+                    }
+                    if (!append(c)) {
+                        return false;
+                    }
+                    ++_pos;
+                    blank = false;
+                }
+                // Rewind over trailing blanks so the caller sees them again.
+                while (_pos > 0 && isBlank(_text[_pos - 1])) {
+                    --_pos;
+                }
+                return angles == 0;
+            }
+
+            const Type* parseSpecifiers() {
+                char name[maxNameLength];
+                std::size_t length = 0;
+                unsigned char cv = cvNone;
+                bool fundamental = false;
+                FundamentalWords words;
+
+                for (;;) {
+                    cv |= parseCv();
+                    std::string_view const word = peekWord();
+                    if (word.empty() && !(length == 0 && _pos + 1 < _text.size() && _text[_pos] == ':' && _text[_pos + 1] == ':')) {
+                        break;
+                    }
+                    if (word == "struct" || word == "class" || word == "union" || word == "enum" || word == "typename") {
+                        _pos += word.size();
+                        continue;
+                    }
+                    if (isFundamentalWord(word)) {
+                        if (length > 0 && !fundamental) {
+                            return nullptr;
+                        }
+                        if (length > 0) {
+                            if (length == maxNameLength) {
+                                return nullptr;
+                            }
+                            name[length++] = ' ';
+                        }
+                        if (length + word.size() > maxNameLength) {
+                            return nullptr;
+                        }
+                        for (char c : word) {
+                            name[length++] = c;
+                        }
+                        _pos += word.size();
+                        fundamental = true;
+                        words.add(word);
+                        continue;
+                    }
+                    if (length > 0) {
+                        break;
+                    }
+                    if (!appendName(name, length)) {
+                        return nullptr;
+                    }
+                }
+
+                if (length == 0 || !words.valid()) {
+                    return nullptr;
+                }
+                return _types.named(std::string_view(name, length), cv);
+            }
+
+            // A '(' opens a nested declarator rather than a parameter list when
+            // a pointer, a reference or another '(' follows.
+            bool atGroupingParen() {
+                if (!peek('(')) {
+                    return false;
+                }
+                std::size_t next = _pos + 1;
+                while (next < _text.size() && isBlank(_text[next])) {
+                    ++next;
+                }
+                return next < _text.size() && (_text[next] == '*' || _text[next] == '&' || _text[next] == '(');
+            }
+
+            bool skipToMatchingParen() {
+                int depth = 0;
+                for (; _pos < _text.size(); ++_pos) {
+                    if (_text[_pos] == '(') {
+                        ++depth;
+                    } else if (_text[_pos] == ')' && --depth == 0) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            const Type* parseTypeId() {
+                Nesting const nesting(*this);
+                if (nesting.tooDeep()) {
+                    return nullptr;
+                }
+                const Type* const base = parseSpecifiers();
+                return base != nullptr ? parseAbstractDeclarator(base) : nullptr;
+            }
+
+            // ptr-operator* direct-abstract-declarator: the operators apply to
+            // base from left to right.
+            const Type* parseAbstractDeclarator(const Type* base) {
+                for (;;) {
+                    if (consume('*')) {
+                        // No pointers to references; the TypeTable would
+                        // quietly make `int&*` an `int*`.
+                        if (base->isReference()) {
+                            return nullptr;
+                        }
+                        base = _types.pointerTo(base, parseCv());
+                    } else if (consume('&')) {
+                        bool const rvalue = _pos < _text.size() && _text[_pos] == '&';
+                        if (rvalue) {
+                            ++_pos;
+                        }
+                        // No references to void, and references collapse only
+                        // through a typedef or a template parameter, never in
+                        // a declarator.
+                        if (isVoid(base) || base->isReference()) {
+                            return nullptr;
+                        }
+                        parseCv();  // cv on a reference is ignored
+                        base = rvalue ? _types.rvalueReferenceTo(base) : _types.lvalueReferenceTo(base);
+                    } else {
+                        return parseDirectDeclarator(base);
+                    }
+                }
+            }
+
+            // `( inner ) suffixes`: the suffixes bind tighter, so they apply to
+            // base first and the inner declarator applies to the result.
+            const Type* parseDirectDeclarator(const Type* base) {
+                Nesting const nesting(*this);
+                if (nesting.tooDeep()) {
+                    return nullptr;
+                }
+                if (!atGroupingParen()) {
+                    return parseSuffixes(base);
+                }
+
+                std::size_t const open = _pos;
+                if (!skipToMatchingParen()) {
+                    return nullptr;
+                }
+                std::size_t const close = _pos;
+                ++_pos;
+
+                const Type* const outer = parseSuffixes(base);
+                if (outer == nullptr) {
+                    return nullptr;
+                }
+                std::size_t const end = _pos;
+
+                _pos = open + 1;
+                const Type* const type = parseAbstractDeclarator(outer);
+                skipBlanks();
+                if (type == nullptr || _pos != close) {
+                    return nullptr;
+                }
+                _pos = end;
+                return type;
+            }
+
+            // Array bounds and parameter lists, innermost (leftmost) last.
+            const Type* parseSuffixes(const Type* base) {
+                Nesting const nesting(*this);
+                if (nesting.tooDeep()) {
+                    return nullptr;
+                }
+
+                if (consume('[')) {
+                    skipBlanks();
+                    // 0 stands for `T[]`, so a written bound must be at least 1,
+                    // and it must fit.
+                    std::size_t bound = 0;
+                    bool const bounded = _pos < _text.size() && _text[_pos] >= '0' && _text[_pos] <= '9';
+                    while (_pos < _text.size() && _text[_pos] >= '0' && _text[_pos] <= '9') {
+                        std::size_t const digit = static_cast<std::size_t>(_text[_pos++] - '0');
+                        if (bound > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+                            return nullptr;
+                        }
+                        bound = bound * 10 + digit;
+                    }
+                    if ((bounded && bound == 0) || !consume(']')) {
+                        return nullptr;
+                    }
+                    // No arrays of functions, references or void.
+                    const Type* const element = parseSuffixes(base);
+                    if (element == nullptr || element->kind == TypeKind::function || element->isReference() || isVoid(element)) {
+                        return nullptr;
+                    }
+                    return _types.arrayOf(element, bound);
+                }
+
+                if (peek('(') && !atGroupingParen()) {
+                    ++_pos;
+                    const Type* params[maxParams];
+                    std::size_t paramCount = 0;
+                    bool variadic = false;
+                    if (!parseParameters(params, paramCount, variadic)) {
+                        return nullptr;
+                    }
+                    // Functions return neither functions nor arrays.
+                    const Type* const result = parseSuffixes(base);
+                    if (result == nullptr || result->kind == TypeKind::function || result->kind == TypeKind::array) {
+                        return nullptr;
+                    }
+                    return _types.function(result, params, paramCount, variadic);
+                }
+
+                return base;
+            }
+
+            bool parseParameters(const Type** params, std::size_t& count, bool& variadic) {
+                if (consume(')')) {
+                    return true;
+                }
+                bool sawVoid = false;
+                for (;;) {
+                    skipBlanks();
+                    if (_text.substr(_pos, 3) == "...") {
+                        _pos += 3;
+                        variadic = true;
+                        if (!consume(')')) {
+                            return false;
+                        }
+                        break;
+                    }
+                    const Type* param = parseTypeId();
+                    if (param == nullptr || count == maxParams) {
+                        return false;
+                    }
+                    sawVoid = sawVoid || isVoid(param);
+                    // The adjustments that make up a function's type.
+                    if (param->kind == TypeKind::array) {
+                        param = _types.pointerTo(param->element);
+                    } else if (param->kind == TypeKind::function) {
+                        param = _types.pointerTo(param);
+                    }
+                    params[count++] = _types.withoutCv(param);
+
+                    if (consume(')')) {
+                        break;
+                    }
+                    if (!consume(',')) {
+                        return false;
+                    }
+                }
+                // `(void)` is an empty parameter list; void is no parameter
+                // anywhere else.
+                if (sawVoid) {
+                    if (count != 1 || variadic) {
+                        return false;
+                    }
+                    count = 0;
+                }
+                return true;
+            }
+        };
+    }
+
+    const Type* parseType(std::string_view spelling, TypeTable& types) {
+        return Parser(spelling, types).parseAll();
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+
+#include "type_model.hpp"
+
+// Reads a type spelling like `int const(* const&)[2]` back into the type model.
+//
+// The parser is a recursive descent over the type-id grammar, following the
+// "go right if you can, go left if you must" rule: inside a parenthesized
+// declarator the suffixes to the right of the parentheses are applied first,
+// then the pointer and reference operators inside them. It works directly on
+// the string_view and keeps no state beyond positions and a few words on the
+// stack, so it never allocates; only types that are not yet in the TypeTable
+// are added to it.
+//
+// Accepted:
+//   - cv-qualifiers before or after the type name (`const int`, `int const`),
+//   - multi-word fundamental types (`unsigned long long`),
+//   - qualified and template names (`std::vector<int>`), kept as one name,
+//   - `*`, `&`, `&&`, arrays with or without a bound, function types with
+//     `()`, `(void)`, parameter lists and `...`,
+//   - any amount of whitespace between tokens, including none.
+//
+// Rejected, as the language has no such types:
+//   - functions returning functions or arrays (`void()()`, `int()[2]`),
+//   - arrays of functions, references or void (`int[2]()`, `int&[2]`),
+//   - pointers to references (`int&*`),
+//   - references to references or to void (`int& &`, `void&`),
+//   - fundamental words that make no type (`int int`, `unsigned double`,
+//     `long long long`),
+//   - void as a parameter other than a lone `(void)` (`void(void, int)`),
+//   - array bounds of zero or past std::size_t (`int[0]`).
+
+namespace ttd {
+    // Returns null if spelling is not a well-formed type-id.
+    const Type* parseType(std::string_view spelling, TypeTable& types);
+}
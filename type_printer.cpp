@@ -0,0 +1,165 @@
+#include "type_printer.hpp"
+
+namespace ttd {
+    namespace {
+        class Printer {
+        public:
+            Printer(char* buffer, std::size_t capacity, PrintStyle style)
+                : _buffer(buffer), _capacity(capacity), _style(style) { }
+
+            std::size_t print(const Type* type) {
+                printLeft(type);
+                printRight(type);
+                return _size;
+            }
+
+        private:
+            char* _buffer;
+            std::size_t _capacity;
+            PrintStyle _style;
+            std::size_t _size = 0;
+            char _last = '\0';
+
+            void put(char c) {
+                if (_size < _capacity) {
+                    _buffer[_size] = c;
+                }
+                ++_size;
+                _last = c;
+            }
+
+            void put(std::string_view s) {
+                for (char c : s) {
+                    put(c);
+                }
+            }
+
+            void putNumber(std::size_t n) {
+                char digits[20];
+                std::size_t count = 0;
+                do {
+                    digits[count++] = static_cast<char>('0' + n % 10);
+                    n /= 10;
+                } while (n > 0);
+                while (count > 0) {
+                    put(digits[--count]);
+                }
+            }
+
+            void putCv(unsigned char cv) {
+                if (cv & cvConst) {
+                    put("const");
+                }
+                if (cv & cvVolatile) {
+                    if (cv & cvConst) {
+                        put(' ');
+                    }
+                    put("volatile");
+                }
+            }
+
+            // The blank in front of a pointer operator or a grouping paren.
+            void separateDeclarator() {
+                if (_style.spacing == Spacing::spaced && _size > 0
+                    && _last != '(' && _last != '*' && _last != '&' && _last != ' ') {
+                    put(' ');
+                }
+            }
+
+            static bool needsGrouping(const Type* element) {
+                return element->kind == TypeKind::array || element->kind == TypeKind::function;
+            }
+
+            void printNamed(const Type* type) {
+                if (type->cv != cvNone && _style.constPlacement == ConstPlacement::west) {
+                    putCv(type->cv);
+                    put(' ');
+                }
+                put(type->name);
+                if (type->cv != cvNone && _style.constPlacement == ConstPlacement::east) {
+                    put(' ');
+                    putCv(type->cv);
+                }
+            }
+
+            // Specifiers and everything of the declarator up to the declarator-id.
+            void printLeft(const Type* type) {
+                switch (type->kind) {
+                case TypeKind::named:
+                    printNamed(type);
+                    break;
+                case TypeKind::pointer:
+                case TypeKind::lvalueReference:
+                case TypeKind::rvalueReference:
+                    printLeft(type->element);
+                    separateDeclarator();
+                    if (needsGrouping(type->element)) {
+                        put('(');
+                    }
+                    if (type->kind == TypeKind::pointer) {
+                        put('*');
+                        if (type->cv != cvNone) {
+                            put(' ');
+                            putCv(type->cv);
+                        }
+                    } else {
+                        put(type->kind == TypeKind::lvalueReference ? "&" : "&&");
+                    }
+                    break;
+                case TypeKind::array:
+                case TypeKind::function:
+                    printLeft(type->element);
+                    break;
+                }
+            }
+
+            // Everything of the declarator after the declarator-id.
+            void printRight(const Type* type) {
+                switch (type->kind) {
+                case TypeKind::named:
+                    break;
+                case TypeKind::pointer:
+                case TypeKind::lvalueReference:
+                case TypeKind::rvalueReference:
+                    if (needsGrouping(type->element)) {
+                        put(')');
+                    }
+                    printRight(type->element);
+                    break;
+                case TypeKind::array:
+                    if (_style.spacing == Spacing::spaced && _last != ')' && _last != ']') {
+                        put(' ');
+                    }
+                    put('[');
+                    if (type->bound > 0) {
+                        putNumber(type->bound);
+                    }
+                    put(']');
+                    printRight(type->element);
+                    break;
+                case TypeKind::function:
+                    if (_style.spacing == Spacing::spaced && _last != ')' && _last != ']') {
+                        put(' ');
+                    }
+                    put('(');
+                    for (std::size_t i = 0; i < type->paramCount; ++i) {
+                        if (i > 0) {
+                            put(", ");
+                        }
+                        print(type->params[i]);
+                    }
+                    if (type->variadic) {
+                        put(type->paramCount > 0 ? ", ..." : "...");
+                    }
+                    put(')');
+                    printRight(type->element);
+                    break;
+                }
+            }
+        };
+    }
+
+    std::size_t printType(const Type* type, char* buffer, std::size_t capacity, PrintStyle style) {
+        return Printer(buffer, capacity, style).print(type);
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+#include "type_model.hpp"
+
+// Prints a type of the model in one canonical spelling.
+//
+// Compilers and demanglers disagree on blanks and on `(void)`: the same type
+// comes out as `int(*&)[2]` or `int (*&)[2]`, `int const *const &` or
+// `int const* const&`. The printer walks the type and emits one spelling per
+// style, so two names of the same type compare equal byte for byte.
+//
+// The declarator is written in two passes over the type, the part left of
+// where a declarator-id would go and the part right of it, straight into the
+// caller's buffer. Nothing is allocated.
+//
+// The default style is east const and compact:
+//   int const* const&    int const(* const&)[2]    void(&)()
+// West const and compact reproduces the names the report prints when built
+// with GCC, byte for byte.
+
+namespace ttd {
+    enum class ConstPlacement : unsigned char {
+        east,               // int const*
+        west,               // const int*
+    };
+
+    enum class Spacing : unsigned char {
+        compact,            // int const* const&, int const(*)[2]
+        spaced,             // int const * const &, int const (*)[2]
+    };
+
+    struct PrintStyle {
+        ConstPlacement constPlacement = ConstPlacement::east;
+        Spacing spacing = Spacing::compact;
+    };
+
+    // Writes the spelling of type into buffer[0, capacity) and returns its
+    // full length. If that is more than capacity, the output is truncated and
+    // the call can be repeated with a buffer of the returned size.
+    std::size_t printType(const Type* type, char* buffer, std::size_t capacity, PrintStyle style = {});
+
+    // Prints into a fixed-size buffer, for the common case of short names.
+    template <std::size_t N>
+    struct PrintedType {
+        char chars[N];
+        std::size_t size;
+
+        bool truncated() const {
+            return size > N;
+        }
+
+        std::string_view view() const {
+            return std::string_view(chars, size > N ? N : size);
+        }
+    };
+
+    template <std::size_t N = 256>
+    PrintedType<N> printType(const Type* type, PrintStyle style = {}) {
+        PrintedType<N> printed;
+        printed.size = printType(type, printed.chars, N, style);
+        return printed;
+    }
+}
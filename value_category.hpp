@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+
+// Value categories, as data and as compile-time facts about expressions.
+//
+// The traits take decltype((expr)): T& is an lvalue, T&& an xvalue and a
+// non-reference a prvalue. The one exception is a function: an rvalue
+// reference to a function is an lvalue, so std::move(f) is one.
+
+namespace ttd {
+    enum class ValueCategory {
+        lvalue,
+        xvalue,
+        prvalue,
+    };
+
+    // Indexed by ValueCategory.
+    constexpr std::string_view valueCategoryNames[] = { "lvalue", "xvalue", "prvalue" };
+
+    constexpr std::string_view valueCategoryName(ValueCategory category) {
+        return valueCategoryNames[static_cast<std::size_t>(category)];
+    }
+
+    // The category named name, if any.
+    constexpr bool parseValueCategory(std::string_view name, ValueCategory& category) {
+        for (std::size_t i = 0; i < std::size(valueCategoryNames); ++i) {
+            if (name == valueCategoryNames[i]) {
+                category = static_cast<ValueCategory>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename T> struct is_lvalue : std::false_type { };
+    template <typename T> struct is_lvalue<T&> : std::true_type { };
+    template <typename T> struct is_lvalue<T&&> : std::is_function<T> { };
+
+    template <typename T> struct is_xvalue : std::false_type { };
+    template <typename T> struct is_xvalue<T&&> : std::bool_constant<!std::is_function_v<T>> { };
+
+    template <typename T> struct is_prvalue : std::bool_constant<!std::is_reference_v<T>> { };
+
+    template <typename T> constexpr bool is_lvalue_v = is_lvalue<T>::value;
+    template <typename T> constexpr bool is_xvalue_v = is_xvalue<T>::value;
+    template <typename T> constexpr bool is_prvalue_v = is_prvalue<T>::value;
+
+    template <typename T>
+    constexpr ValueCategory valueCategoryOf = is_lvalue_v<T> ? ValueCategory::lvalue
+                                            : is_xvalue_v<T> ? ValueCategory::xvalue
+                                                             : ValueCategory::prvalue;
+
+    // A category as a type, to overload or specialize on.
+    template <ValueCategory Category>
+    using ValueCategoryConstant = std::integral_constant<ValueCategory, Category>;
+}
+
+// The category of expr as a constant expression; expr is not evaluated.
+#define TTD_VALUE_CATEGORY(expr) (::ttd::valueCategoryOf<decltype((expr))>)
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of threads that run batches of indexed tasks.
+//
+// run(count, task) calls task(0) .. task(count - 1), each exactly once, and
+// returns when all are done. The indices are dealt round-robin onto one deque
+// per thread; a thread works from the back of its own deque and, when that is
+// empty, steals from the front of the others', so a thread that drew cheap
+// tasks helps with the expensive ones. The calling thread takes part, so a
+// pool of N threads starts N - 1.
+//
+// If a task throws, the remaining tasks still run and run() rethrows the
+// first exception.
+
+namespace ttd {
+    class WorkStealingPool {
+    public:
+        explicit WorkStealingPool(std::size_t threadCount) {
+            std::size_t const count = threadCount > 0 ? threadCount : 1;
+            for (std::size_t i = 0; i < count; ++i) {
+                _queues.push_back(std::make_unique<Queue>());
+            }
+            for (std::size_t i = 1; i < count; ++i) {
+                _threads.emplace_back([this, i] { serve(i); });
+            }
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _wake.notify_all();
+            for (std::thread& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        std::size_t size() const {
+            return _queues.size();
+        }
+
+        void run(std::size_t count, const std::function<void(std::size_t)>& task) {
+            if (count == 0) {
+                return;
+            }
+            // The task is published with the generation, before any index,
+            // so a thread that joins this run finds the task it belongs to.
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _task = &task;
+                _remaining.store(count, std::memory_order_relaxed);
+                _error = nullptr;
+                ++_generation;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                Queue& queue = *_queues[i % _queues.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(i);
+            }
+            _wake.notify_all();
+
+            work(0, task);
+
+            // Every thread that joined this run must have left it before the
+            // next run can push indices, or it would run them with this task.
+            std::unique_lock<std::mutex> lock(_mutex);
+            _done.wait(lock, [this] { return _remaining.load(std::memory_order_acquire) == 0 && _active == 0; });
+            _task = nullptr;
+            if (_error) {
+                std::rethrow_exception(_error);
+            }
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::size_t> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> _queues;
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+        const std::function<void(std::size_t)>* _task = nullptr;
+        std::atomic<std::size_t> _remaining{ 0 };
+        std::size_t _active = 0;            // threads in work() for this run
+        std::size_t _generation = 0;
+        std::exception_ptr _error;
+        bool _stopping = false;
+
+        void serve(std::size_t self) {
+            std::size_t seen = 0;
+            for (;;) {
+                const std::function<void(std::size_t)>* task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    // A run that ended before this thread woke has no task
+                    // left; wait for the next one.
+                    _wake.wait(lock, [&] { return _stopping || (_generation != seen && _task != nullptr); });
+                    if (_stopping) {
+                        return;
+                    }
+                    seen = _generation;
+                    task = _task;
+                    ++_active;
+                }
+                work(self, *task);
+
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (--_active == 0) {
+                    _done.notify_all();
+                }
+            }
+        }
+
+        bool take(std::size_t self, std::size_t& index) {
+            {
+                Queue& own = *_queues[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    index = own.tasks.back();
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t i = 1; i < _queues.size(); ++i) {
+                Queue& victim = *_queues[(self + i) % _queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    index = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Takes only the queue locks per task; _mutex is for errors and for
+        // the last task of the run.
+        void work(std::size_t self, const std::function<void(std::size_t)>& task) {
+            for (std::size_t index; take(self, index);) {
+                try {
+                    task(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (!_error) {
+                        _error = std::current_exception();
+                    }
+                }
+                if (_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _done.notify_all();
+                }
+            }
+        }
+    };
+}